@@ -1,24 +1,34 @@
 #include "anima.h"
 #include "pm.h"
+#include "pm_budget.h"
 
 #include "lvgl.h"
 #include <stdlib.h>
 
 #define POPUP_TOP_HEIGHT 15
-
-// 全局动画对象（lvgl动画结构体）
-lv_anim_t appear_anima;     // 页面出现动画
-lv_anim_t disAppear_anima;  // 页面消失动画
+#define ANIMA_TIME 500
 
 /**
- * @brief 动画数据结构，传递动画所需的回调和页面信息
+ * @brief 动画数据结构，保存一个页面正在进行的过渡动画
+ *
+ * 从预分配的动画池中取得，动画结束后归还，过渡期间不申请堆内存（快照缓冲区除外）
  */
 typedef struct _lv_pm_anima_data {
+  bool active;                        // 是否正在使用
+  lv_anim_t anim;                     // lvgl动画对象（每个页面一个，互不覆盖）
+  lv_anim_exec_xcb_t exec_cb;         // 动画执行回调
+  int32_t end;                        // 动画终点
   lv_pm_page_t *pm_page;              // 页面对象指针
   lv_pm_anima_complete_cb cb;         // 动画完成回调
   lv_pm_open_options_t options;       // 页面打开选项
+  lv_obj_t *snapshot;                 // 快照过渡时代替页面移动的图片对象，NULL表示移动页面本身
+  lv_img_dsc_t snapshot_dsc;          // 快照图像描述
+  void *snapshot_buf;                 // 快照像素缓冲区
 } lv_pm_anima_data;
 
+// 动画池
+static lv_pm_anima_data anima_pool[LV_PM_ANIMA_POOL_SIZE];
+
 /**
  * @brief X方向平移动画回调
  * @param var 页面对象
@@ -40,14 +50,123 @@ static void translateY_anima_cb(void *var, int32_t v)
 }
 
 /**
- * @brief 动画结束回调，调用页面动画完成回调，并释放动画数据
+ * @brief 查找页面正在进行的动画
+ * @param pm_page 页面对象
+ * @return 动画数据，没有时返回NULL
+ */
+static lv_pm_anima_data *anima_find(lv_pm_page_t *pm_page)
+{
+  for (int i = 0; i < LV_PM_ANIMA_POOL_SIZE; i++) {
+    if (anima_pool[i].active && anima_pool[i].pm_page == pm_page) {
+      return &anima_pool[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief 动画结束：页面停在终点，归还动画数据，再调用页面动画完成回调
+ * @param anima_data 动画数据
+ */
+static void anima_complete(lv_pm_anima_data *anima_data)
+{
+  lv_obj_t *page = anima_data->pm_page->page;
+
+  anima_data->exec_cb(page, anima_data->end);
+  if (anima_data->snapshot) {
+    // 快照过渡结束：真实页面重新显示，删除快照
+    lv_obj_clear_flag(page, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_del(anima_data->snapshot);
+    free(anima_data->snapshot_buf);
+    anima_data->snapshot = NULL;
+    anima_data->snapshot_buf = NULL;
+  }
+  // 先归还，完成回调中可能立即开始新的过渡
+  anima_data->active = false;
+  anima_data->cb(anima_data->pm_page, anima_data->options);
+}
+
+/**
+ * @brief 动画结束回调
  * @param anim 动画对象
  */
 static void anima_ready_cb(lv_anim_t *anim)
 {
-  lv_pm_anima_data *cb_data = (lv_pm_anima_data *)anim->user_data;
-  cb_data->cb(cb_data->pm_page, cb_data->options);
-  free(anim->user_data);
+  anima_complete((lv_pm_anima_data *)anim->user_data);
+}
+
+/**
+ * @brief 返回动画要移动的对象
+ * @param anima_data 动画数据
+ *
+ * 快照过渡时把页面截图成一张图片，放在页面所在层级上代替页面做动画，
+ * 动画期间每帧只需绘制图片，不再重绘页面的整棵控件树。
+ * 快照不可用（未启用LV_USE_SNAPSHOT或内存不足）时移动页面本身。
+ */
+static void *anima_target(lv_pm_anima_data *anima_data)
+{
+  lv_obj_t *page = anima_data->pm_page->page;
+  anima_data->snapshot = NULL;
+  anima_data->snapshot_buf = NULL;
+
+#if LV_USE_SNAPSHOT
+  if (anima_data->options.snapshot) {
+    // 弹窗有圆角，需要带透明度的快照
+    lv_img_cf_t cf = anima_data->options.animation == LV_PM_ANIMA_POPUP ? LV_IMG_CF_TRUE_COLOR_ALPHA
+                                                                         : LV_IMG_CF_TRUE_COLOR;
+    lv_obj_update_layout(page);
+    uint32_t size = lv_snapshot_buf_size_needed(page, cf);
+    void *buf = malloc(size);
+    if (buf == NULL) {
+      return page;
+    }
+    if (lv_snapshot_take_to_buf(page, cf, &anima_data->snapshot_dsc, buf, size) != LV_RES_OK) {
+      free(buf);
+      return page;
+    }
+
+    lv_obj_t *img = lv_img_create(lv_obj_get_parent(page));
+    lv_img_set_src(img, &anima_data->snapshot_dsc);
+    lv_obj_clear_flag(img, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_pos(img, lv_obj_get_x(page), lv_obj_get_y(page));
+    lv_obj_move_to_index(img, lv_obj_get_index(page)); // 保持页面原来的层叠顺序
+    lv_obj_add_flag(page, LV_OBJ_FLAG_HIDDEN);
+    anima_data->snapshot = img;
+    anima_data->snapshot_buf = buf;
+    return img;
+  }
+#endif
+  return page;
+}
+
+/**
+ * @brief 启动页面过渡动画
+ * @param anima_data 动画数据
+ * @param exec_cb 动画执行回调
+ * @param start 起点
+ * @param end 终点
+ *
+ * 动画时间按过渡期间测得的帧间隔缩短，见pm_budget.h
+ */
+static void anima_start(lv_pm_anima_data *anima_data, lv_anim_exec_xcb_t exec_cb, int32_t start, int32_t end)
+{
+  lv_anim_t *anim = &anima_data->anim;
+  uint32_t time = lv_pm_budget_time(ANIMA_TIME);
+
+  anima_data->exec_cb = exec_cb;
+  anima_data->end = end;
+
+  lv_anim_init(anim);
+  lv_anim_set_user_data(anim, (void *)anima_data);
+  lv_anim_set_var(anim, anima_target(anima_data));
+  lv_anim_set_values(anim, start, end);
+  lv_anim_set_path_cb(anim, lv_anim_path_ease_out);
+  lv_anim_set_time(anim, time);
+  lv_anim_set_repeat_count(anim, 1);
+  lv_anim_set_exec_cb(anim, exec_cb);
+  lv_anim_set_ready_cb(anim, anima_ready_cb);
+  lv_anim_start(anim);
+  lv_pm_budget_probe(time);
 }
 
 /**
@@ -66,24 +185,13 @@ static void _pm_slide_appear(lv_pm_anima_data *anima_data)
 {
   lv_coord_t width = lv_disp_get_hor_res(NULL);
 
-  lv_anim_init(&appear_anima);
-  lv_anim_set_user_data(&appear_anima, (void *)anima_data);
-  lv_anim_set_var(&appear_anima, anima_data->pm_page->page);
-
   if (anima_data->pm_page->_back) {
     // 返回时从左滑入
-    lv_anim_set_values(&appear_anima, -width, 0);
+    anima_start(anima_data, translateX_anima_cb, -width, 0);
   } else {
     // 正常打开从右滑入
-    lv_anim_set_values(&appear_anima, width, 0);
+    anima_start(anima_data, translateX_anima_cb, width, 0);
   }
-
-  lv_anim_set_path_cb(&appear_anima, lv_anim_path_ease_out);
-  lv_anim_set_time(&appear_anima, 500);
-  lv_anim_set_repeat_count(&appear_anima, 1);
-  lv_anim_set_exec_cb(&appear_anima, translateX_anima_cb);
-  lv_anim_set_ready_cb(&appear_anima, anima_ready_cb);
-  lv_anim_start(&appear_anima);
 }
 
 /**
@@ -96,24 +204,13 @@ static void _pm_slide_disAppear(lv_pm_anima_data *anima_data)
 {
   lv_coord_t width = lv_disp_get_hor_res(NULL);
 
-  lv_anim_init(&disAppear_anima);
-  lv_anim_set_user_data(&disAppear_anima, (void *)anima_data);
-  lv_anim_set_var(&disAppear_anima, anima_data->pm_page->page);
-
   if (anima_data->pm_page->_back) {
     // 返回时向右滑出
-    lv_anim_set_values(&disAppear_anima, 0, width);
+    anima_start(anima_data, translateX_anima_cb, 0, width);
   } else {
     // 正常关闭向左滑出
-    lv_anim_set_values(&disAppear_anima, 0, -width);
+    anima_start(anima_data, translateX_anima_cb, 0, -width);
   }
-
-  lv_anim_set_time(&disAppear_anima, 500);
-  lv_anim_set_repeat_count(&disAppear_anima, 1);
-  lv_anim_set_exec_cb(&disAppear_anima, translateX_anima_cb);
-  lv_anim_set_ready_cb(&disAppear_anima, anima_ready_cb);
-  lv_anim_set_path_cb(&disAppear_anima, lv_anim_path_ease_out);
-  lv_anim_start(&disAppear_anima);
 }
 
 /** ------------------------------------slide animation end-------------------------------------------- */
@@ -128,31 +225,22 @@ static void _pm_slide_disAppear(lv_pm_anima_data *anima_data)
 /**
  * @brief popup页面出现动画（从下往上弹出）
  * @param anima_data 动画数据
+ *
+ * 圆角在截图前设置
  */
 static void _pm_popup_appear(lv_pm_anima_data *anima_data)
 {
   lv_coord_t height = lv_disp_get_ver_res(NULL);
 
-  lv_anim_init(&appear_anima);
-  lv_anim_set_user_data(&appear_anima, (void *)anima_data);
-  lv_anim_set_var(&appear_anima, anima_data->pm_page->page);
-
   if (anima_data->pm_page->_back) {
     // 返回弹窗时小幅度弹出
-    lv_anim_set_values(&appear_anima, 5, 0);
     lv_obj_set_style_radius(anima_data->pm_page->page, 0, LV_STATE_DEFAULT);
+    anima_start(anima_data, translateY_anima_cb, 5, 0);
   } else {
     // 正常弹窗从屏幕底部弹出到顶部
-    lv_anim_set_values(&appear_anima, height, POPUP_TOP_HEIGHT);
     lv_obj_set_style_radius(anima_data->pm_page->page, 10, LV_STATE_DEFAULT);
+    anima_start(anima_data, translateY_anima_cb, height, POPUP_TOP_HEIGHT);
   }
-
-  lv_anim_set_path_cb(&appear_anima, lv_anim_path_ease_out);
-  lv_anim_set_time(&appear_anima, 500);
-  lv_anim_set_repeat_count(&appear_anima, 1);
-  lv_anim_set_exec_cb(&appear_anima, translateY_anima_cb);
-  lv_anim_set_ready_cb(&appear_anima, anima_ready_cb);
-  lv_anim_start(&appear_anima);
 }
 
 /**
@@ -163,30 +251,73 @@ static void _pm_popup_disAppear(lv_pm_anima_data *anima_data)
 {
   lv_coord_t height = lv_disp_get_ver_res(NULL);
 
-  lv_anim_init(&disAppear_anima);
-  lv_anim_set_user_data(&disAppear_anima, (void *)anima_data);
-  lv_anim_set_var(&disAppear_anima, anima_data->pm_page->page);
-
   if (anima_data->pm_page->_back) {
     // 返回时弹窗从顶部回到底部
-    lv_anim_set_values(&disAppear_anima, POPUP_TOP_HEIGHT, height);
     lv_obj_set_style_radius(anima_data->pm_page->page, 0, LV_STATE_DEFAULT);
+    anima_start(anima_data, translateY_anima_cb, POPUP_TOP_HEIGHT, height);
   } else {
     // 正常关闭时微量下移再消失
-    lv_anim_set_values(&disAppear_anima, 0, 5);
     lv_obj_set_style_radius(anima_data->pm_page->page, 10, LV_STATE_DEFAULT);
+    anima_start(anima_data, translateY_anima_cb, 0, 5);
   }
-
-  lv_anim_set_time(&disAppear_anima, 500);
-  lv_anim_set_repeat_count(&disAppear_anima, 1);
-  lv_anim_set_exec_cb(&disAppear_anima, translateY_anima_cb);
-  lv_anim_set_ready_cb(&disAppear_anima, anima_ready_cb);
-  lv_anim_set_path_cb(&disAppear_anima, lv_anim_path_ease_out);
-  lv_anim_start(&disAppear_anima);
 }
 
 /** ------------------------------------popup animation end-------------------------------------------- */
 
+/**
+ * @brief 立即结束页面正在进行的过渡动画
+ * @param pm_page 页面对象
+ *
+ * 页面停在动画终点并调用动画完成回调，与动画自然结束的效果相同
+ */
+void _pm_anima_finish(lv_pm_page_t *pm_page)
+{
+  lv_pm_anima_data *anima_data = anima_find(pm_page);
+  if (anima_data == NULL) {
+    return;
+  }
+  lv_anim_del(anima_data->anim.var, anima_data->exec_cb); // 删除动画不会调用ready_cb
+  anima_complete(anima_data);
+}
+
+/**
+ * @brief 从动画池取得页面的动画数据
+ * @param pm_page 页面对象
+ * @param behavior 打开选项
+ * @param cb 动画完成回调
+ * @return 动画数据，不需要动画或动画池已用完时返回NULL
+ *
+ * 页面还有未结束的过渡时先立即结束它，保证生命周期回调按顺序成对调用。
+ * 渲染跟不上时（见pm_budget.h）改用快照移动，严重时不做动画
+ */
+static lv_pm_anima_data *anima_acquire(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior,
+                                       lv_pm_anima_complete_cb cb)
+{
+  _pm_anima_finish(pm_page);
+
+  if (behavior->animation != LV_PM_ANIMA_SLIDE && behavior->animation != LV_PM_ANIMA_POPUP) {
+    return NULL;
+  }
+  lv_pm_anima_level_t level = lv_pm_budget_level();
+  if (level == LV_PM_ANIMA_LEVEL_CUT) {
+    return NULL;
+  }
+  for (int i = 0; i < LV_PM_ANIMA_POOL_SIZE; i++) {
+    lv_pm_anima_data *anima_data = &anima_pool[i];
+    if (!anima_data->active) {
+      anima_data->active = true;
+      anima_data->pm_page = pm_page;
+      anima_data->cb = cb;
+      anima_data->options = *behavior;
+      if (level == LV_PM_ANIMA_LEVEL_CHEAP) {
+        anima_data->options.snapshot = true;
+      }
+      return anima_data;
+    }
+  }
+  return NULL;
+}
+
 /**
  * @brief 页面出现动画启动入口
  * @param pm_page 页面对象
@@ -197,32 +328,21 @@ static void _pm_popup_disAppear(lv_pm_anima_data *anima_data)
  */
 void _pm_anima_appear(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior, lv_pm_anima_complete_cb cb)
 {
-  if (behavior == NULL || behavior->animation == LV_PM_ANIMA_NONE) {
-    cb(pm_page, *behavior);
-    return;
+  lv_pm_open_options_t none = {0};
+  if (behavior == NULL) {
+    behavior = &none;
   }
 
-  lv_pm_anima_data *anima_data = (lv_pm_anima_data *)malloc(sizeof(lv_pm_anima_data));
+  lv_pm_anima_data *anima_data = anima_acquire(pm_page, behavior, cb);
   if (anima_data == NULL) {
     cb(pm_page, *behavior);
     return;
   }
 
-  anima_data->pm_page = pm_page;
-  anima_data->cb = cb;
-  anima_data->options = *behavior;
-
-  switch (behavior->animation)
-  {
-  case LV_PM_ANIMA_SLIDE:
+  if (behavior->animation == LV_PM_ANIMA_SLIDE) {
     _pm_slide_appear(anima_data);
-    break;
-  case LV_PM_ANIMA_POPUP:
+  } else {
     _pm_popup_appear(anima_data);
-    break;
-  default:
-    cb(pm_page, *behavior);
-    break;
   }
 }
 
@@ -236,31 +356,20 @@ void _pm_anima_appear(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior, lv_
  */
 void _pm_anima_disAppear(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior, lv_pm_anima_complete_cb cb)
 {
-  if (behavior == NULL || behavior->animation == LV_PM_ANIMA_NONE) {
-    cb(pm_page, *behavior);
-    return;
+  lv_pm_open_options_t none = {0};
+  if (behavior == NULL) {
+    behavior = &none;
   }
 
-  lv_pm_anima_data *anima_data = (lv_pm_anima_data *)malloc(sizeof(lv_pm_anima_data));
+  lv_pm_anima_data *anima_data = anima_acquire(pm_page, behavior, cb);
   if (anima_data == NULL) {
     cb(pm_page, *behavior);
     return;
   }
 
-  anima_data->pm_page = pm_page;
-  anima_data->cb = cb;
-  anima_data->options = *behavior;
-
-  switch (behavior->animation)
-  {
-  case LV_PM_ANIMA_SLIDE:
+  if (behavior->animation == LV_PM_ANIMA_SLIDE) {
     _pm_slide_disAppear(anima_data);
-    break;
-  case LV_PM_ANIMA_POPUP:
+  } else {
     _pm_popup_disAppear(anima_data);
-    break;
-  default:
-    cb(pm_page, *behavior);
-    break;
   }
-}
\ No newline at end of file
+}
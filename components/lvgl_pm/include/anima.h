@@ -3,6 +3,10 @@
 
 #include "pm.h"
 
+#ifndef LV_PM_ANIMA_POOL_SIZE
+#define LV_PM_ANIMA_POOL_SIZE LV_PM_PAGE_NUM ///< 动画池大小（同时进行过渡的页面数量上限）
+#endif
+
 // 页面动画完成回调函数指针
 typedef void (*lv_pm_anima_complete_cb)(lv_pm_page_t *pm_page, lv_pm_open_options_t options);
 
@@ -12,4 +16,7 @@ void _pm_anima_appear(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior, lv_
 // 页面消失动画启动入口
 void _pm_anima_disAppear(lv_pm_page_t *pm_page, lv_pm_open_options_t *behavior, lv_pm_anima_complete_cb cb);
 
+// 立即结束页面正在进行的过渡动画（停在终点并调用完成回调）
+void _pm_anima_finish(lv_pm_page_t *pm_page);
+
 #endif
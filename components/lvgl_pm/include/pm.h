@@ -53,6 +53,7 @@ typedef struct _lv_pm_open_options_t
   enum LV_PM_PAGE_ANIMA animation; // 动画类型
   enum LV_PM_OPEN_TARGET target;   // 打开目标方式
   enum LV_PM_ANIMA_DIR direction;  // 动画方向
+  bool snapshot;                   // 快照过渡：动画期间移动页面截图而不是真实页面（需要LV_USE_SNAPSHOT）
 } lv_pm_open_options_t;
 
 /**
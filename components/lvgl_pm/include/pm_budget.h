@@ -0,0 +1,70 @@
+#ifndef PM_BUDGET_H
+#define PM_BUDGET_H
+
+#include "lvgl.h"
+
+/**
+ * @defgroup LV_PM_BUDGET_CONFIG 过渡动画帧预算配置
+ * @brief 过渡期间测量实际帧间隔，渲染跟不上时缩短动画或换成更省的效果
+ * @{
+ */
+#ifndef LV_PM_FRAME_BUDGET_MS
+#define LV_PM_FRAME_BUDGET_MS 40    ///< 帧间隔不超过此值时使用完整动画（约25fps）
+#endif
+#ifndef LV_PM_FRAME_SLOW_MS
+#define LV_PM_FRAME_SLOW_MS 70      ///< 超过预算但不超过此值时缩短动画
+#endif
+#ifndef LV_PM_FRAME_CUT_MS
+#define LV_PM_FRAME_CUT_MS 120      ///< 超过SLOW不超过此值时换成不带渐变的平移，超过时直接切换
+#endif
+#ifndef LV_PM_ANIMA_MIN_TIME
+#define LV_PM_ANIMA_MIN_TIME 150    ///< 缩短后的最短动画时间（毫秒）
+#endif
+#ifndef LV_PM_BUDGET_RETRY_MS
+#define LV_PM_BUDGET_RETRY_MS 3000  ///< 直接切换后经过此时间重新尝试动画（直接切换时无法测量）
+#endif
+/** @} */
+
+/**
+ * @brief 动画等级
+ */
+typedef enum {
+  LV_PM_ANIMA_LEVEL_FULL,  ///< 完整动画
+  LV_PM_ANIMA_LEVEL_SHORT, ///< 缩短时间
+  LV_PM_ANIMA_LEVEL_CHEAP, ///< 缩短时间，渐变换成平移，页面使用快照移动
+  LV_PM_ANIMA_LEVEL_CUT,   ///< 不做动画，直接切换
+} lv_pm_anima_level_t;
+
+/**
+ * @brief 开始测量一次过渡的帧间隔
+ * @param time 过渡时间（毫秒），为0时不测量
+ *
+ * 用一个与过渡等长的空动画采样：动画定时器每帧执行一次，渲染超时时两次执行的间隔随之变长
+ */
+void lv_pm_budget_probe(uint32_t time);
+
+/**
+ * @brief 当前动画等级
+ */
+lv_pm_anima_level_t lv_pm_budget_level(void);
+
+/**
+ * @brief 按当前动画等级调整动画时间
+ * @param time 原动画时间（毫秒）
+ * @return 调整后的时间，LV_PM_ANIMA_LEVEL_CUT时为0
+ */
+uint32_t lv_pm_budget_time(uint32_t time);
+
+/**
+ * @brief 按当前动画等级调整界面切换动画，并开始测量
+ * @param anim 切换动画类型，可能被改为平移或LV_SCR_LOAD_ANIM_NONE
+ * @param time 动画时间（毫秒），可能被缩短
+ */
+void lv_pm_budget_scr_anim(lv_scr_load_anim_t *anim, uint32_t *time);
+
+/**
+ * @brief 过渡期间的平均帧间隔（毫秒），未测量过时为0
+ */
+uint32_t lv_pm_budget_frame_ms(void);
+
+#endif
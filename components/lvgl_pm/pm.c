@@ -156,6 +156,11 @@ uint8_t lv_pm_open_page(uint8_t id, lv_pm_open_options_t *behavior) {
     }
     lv_pm_history[lv_pm_history_len] = id; // 将页面ID加入历史
     lv_pm_page_t *pm_page = lv_pm_router[id]; // 从路由表中获取页面对象
+    // 快速连续导航时，先结束相关页面上一次的过渡，再开始新的过渡
+    _pm_anima_finish(pm_page);
+    if (lv_pm_history_len > 0) {
+        _pm_anima_finish(lv_pm_router[lv_pm_history[lv_pm_history_len - 1]]);
+    }
     lv_obj_t *page = pm_page->page; // 获取页面对象指针
     // 如果存在行为参数，则更新页面对象
     if (behavior) {
@@ -219,6 +224,9 @@ uint8_t lv_pm_back() {
     }
     uint8_t pid = lv_pm_history[lv_pm_history_len - 1]; // 取出当前页面对象ID
     lv_pm_page_t *pm_page = lv_pm_router[pid]; // 根据ID从路由表中获取页面对象
+    // 快速连续导航时，先结束相关页面上一次的过渡，再开始新的过渡
+    _pm_anima_finish(pm_page);
+    _pm_anima_finish(lv_pm_router[lv_pm_history[lv_pm_history_len - 2]]);
     pm_page->_back = true; // 标记返回操作
     lv_obj_t *page = pm_page->page; // 获取页面指针
 
@@ -0,0 +1,118 @@
+#include "pm_budget.h"
+
+static uint32_t frame_avg = 0;      // 过渡期间的平均帧间隔（毫秒），0表示未测量
+static uint32_t last_sample = 0;    // 最近一次采样的时刻
+static uint32_t probe_last = 0;     // 本次过渡上一帧的时刻
+static uint8_t probe_frames = 0;    // 本次过渡已执行的帧数
+static lv_pm_anima_level_t level = LV_PM_ANIMA_LEVEL_FULL;
+static int probe_var;               // 测量动画的对象（只用作动画标识）
+
+/**
+ * @brief 测量动画回调，每帧执行一次
+ * @param var 未使用
+ * @param v   未使用
+ *
+ * 前两次执行的间隔包含页面创建和截图的耗时，不计入
+ */
+static void probe_exec_cb(void *var, int32_t v)
+{
+  uint32_t now = lv_tick_get();
+
+  if (probe_frames < 2) {
+    probe_frames++;
+    probe_last = now;
+    return;
+  }
+  uint32_t elaps = lv_tick_elaps(probe_last);
+  probe_last = now;
+  if (elaps == 0) {
+    return;
+  }
+  frame_avg = frame_avg ? (frame_avg * 3 + elaps) / 4 : elaps;
+  last_sample = now;
+}
+
+void lv_pm_budget_probe(uint32_t time)
+{
+  if (time == 0) {
+    return;
+  }
+  lv_anim_t anim;
+
+  probe_frames = 0;
+  lv_anim_init(&anim);
+  lv_anim_set_var(&anim, &probe_var);
+  lv_anim_set_values(&anim, 0, 1);
+  lv_anim_set_time(&anim, time);
+  lv_anim_set_exec_cb(&anim, probe_exec_cb);
+  lv_anim_start(&anim); // 替换上一次过渡未结束的测量
+}
+
+lv_pm_anima_level_t lv_pm_budget_level(void)
+{
+  // 直接切换时没有过渡可以测量，过一段时间降回平移动画重新测量
+  if (frame_avg > LV_PM_FRAME_CUT_MS && lv_tick_elaps(last_sample) > LV_PM_BUDGET_RETRY_MS) {
+    frame_avg = LV_PM_FRAME_CUT_MS;
+  }
+
+  lv_pm_anima_level_t new_level;
+  if (frame_avg <= LV_PM_FRAME_BUDGET_MS) {
+    new_level = LV_PM_ANIMA_LEVEL_FULL;
+  } else if (frame_avg <= LV_PM_FRAME_SLOW_MS) {
+    new_level = LV_PM_ANIMA_LEVEL_SHORT;
+  } else if (frame_avg <= LV_PM_FRAME_CUT_MS) {
+    new_level = LV_PM_ANIMA_LEVEL_CHEAP;
+  } else {
+    new_level = LV_PM_ANIMA_LEVEL_CUT;
+  }
+  if (new_level != level) {
+    LV_LOG_INFO("anima level %d -> %d (frame %u ms)", level, new_level, (unsigned)frame_avg);
+    level = new_level;
+  }
+  return level;
+}
+
+uint32_t lv_pm_budget_time(uint32_t time)
+{
+  switch (lv_pm_budget_level()) {
+  case LV_PM_ANIMA_LEVEL_FULL:
+    return time;
+  case LV_PM_ANIMA_LEVEL_CUT:
+    return 0;
+  default:
+    break;
+  }
+  // 按帧间隔等比缩短，保持动画的帧数大致不变
+  uint32_t t = time * LV_PM_FRAME_BUDGET_MS / frame_avg;
+  if (t < LV_PM_ANIMA_MIN_TIME) {
+    t = LV_PM_ANIMA_MIN_TIME < time ? LV_PM_ANIMA_MIN_TIME : time;
+  }
+  return t;
+}
+
+void lv_pm_budget_scr_anim(lv_scr_load_anim_t *anim, uint32_t *time)
+{
+  if (*anim == LV_SCR_LOAD_ANIM_NONE) {
+    return;
+  }
+
+  *time = lv_pm_budget_time(*time);
+  if (*time == 0) {
+    *anim = LV_SCR_LOAD_ANIM_NONE;
+    return;
+  }
+  if (level == LV_PM_ANIMA_LEVEL_CHEAP) {
+    // 渐变每帧都要混合整个屏幕，换成只移动新界面（或旧界面）的平移
+    if (*anim == LV_SCR_LOAD_ANIM_FADE_IN) {
+      *anim = LV_SCR_LOAD_ANIM_OVER_LEFT;
+    } else if (*anim == LV_SCR_LOAD_ANIM_FADE_OUT) {
+      *anim = LV_SCR_LOAD_ANIM_OUT_RIGHT;
+    }
+  }
+  lv_pm_budget_probe(*time);
+}
+
+uint32_t lv_pm_budget_frame_ms(void)
+{
+  return frame_avg;
+}
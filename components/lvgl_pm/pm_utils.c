@@ -1,5 +1,9 @@
 #include "pm_utils.h"
 
+// 所有页面共用的样式，不在每个页面上单独申请本地样式
+static lv_style_t reset_style;
+static bool reset_style_inited = false;
+
 /**
  * @brief 重置LVGL对象的样式：边框宽度、圆角半径、内边距均设为0
  *
@@ -7,7 +11,12 @@
  */
 void pm_reset_style(lv_obj_t *obj)
 {
-  lv_obj_set_style_border_width(obj, 0, LV_STATE_DEFAULT); // 取消边框
-  lv_obj_set_style_radius(obj, 0, LV_STATE_DEFAULT);       // 取消圆角
-  lv_obj_set_style_pad_all(obj, 0, LV_STATE_DEFAULT);      // 取消所有内边距
-}
\ No newline at end of file
+  if (!reset_style_inited) {
+    lv_style_init(&reset_style);
+    lv_style_set_border_width(&reset_style, 0); // 取消边框
+    lv_style_set_radius(&reset_style, 0);       // 取消圆角
+    lv_style_set_pad_all(&reset_style, 0);      // 取消所有内边距
+    reset_style_inited = true;
+  }
+  lv_obj_add_style(obj, &reset_style, LV_STATE_DEFAULT);
+}
@@ -0,0 +1,24 @@
+#ifndef MQTT_CHART_DISPLAY_H
+#define MQTT_CHART_DISPLAY_H
+
+#include "lvgl.h"
+#include <stdbool.h>
+
+#define CHART_POINTS            150     ///< 图表点数（降采样目标）
+#define CHART_Y_SCALE           1000    ///< 图表纵轴归一化范围
+#define CHART_REFRESH_MS        100     ///< 图表刷新周期（毫秒，只在图表界面显示时运行）
+
+// 绑定图表界面组件（图表、主题下拉框、字段下拉框、算法下拉框、统计标签）
+void mqtt_chart_bind(lv_obj_t *chart, lv_obj_t *topic_dd, lv_obj_t *field_dd,
+                     lv_obj_t *mode_dd, lv_obj_t *stats_label);
+
+// 解除绑定（图表界面被删除前调用）
+void mqtt_chart_unbind(void);
+
+// 从消息存储刷新主题下拉列表
+void mqtt_chart_refresh_topics(void);
+
+// 指定绘制的主题和JSON字段（字段为NULL或空字符串时自动识别）
+void mqtt_chart_select(const char *topic, const char *field);
+
+#endif
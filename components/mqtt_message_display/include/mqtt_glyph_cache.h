@@ -0,0 +1,31 @@
+/**
+ * @file mqtt_glyph_cache.h
+ * @brief 日志字体的预光栅化字形缓存
+ *
+ * 启动时把基础字体中可打印ASCII字符（0x20~0x7E）的字形一次性展开为8位灰度位图，
+ * 连同字形参数和字距表放在内部RAM中。绘制时按字符直接索引，省去基础字体的
+ * 码表查找和4位像素的逐位拆解；其他字符回退到基础字体绘制。
+ */
+
+#ifndef MQTT_GLYPH_CACHE_H
+#define MQTT_GLYPH_CACHE_H
+
+#include "lvgl.h"
+
+/**
+ * @defgroup GLYPH_CACHE_CONFIG 字形缓存配置
+ * @{
+ */
+#define GLYPH_CACHE_ENABLE 1     ///< 为0时日志直接使用基础字体（效果用基准测试构建的"glyph"结果对比）
+#define GLYPH_CACHE_FIRST  0x20  ///< 缓存的第一个字符
+#define GLYPH_CACHE_LAST   0x7E  ///< 缓存的最后一个字符
+/** @} */
+
+/**
+ * @brief 为基础字体建立字形缓存（只能建立一个）
+ * @param base 基础字体（位图须为1/2/4/8位灰度）
+ * @return 带缓存的字体；内存不足或字体格式不支持时返回base
+ */
+const lv_font_t *glyph_cache_create(const lv_font_t *base);
+
+#endif
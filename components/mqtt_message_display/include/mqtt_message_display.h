@@ -3,11 +3,17 @@
 
 #include "lvgl.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 // 初始化消息显示管理器（传入现有的UI组件）
 void mqtt_display_init(lv_obj_t *textarea_obj, lv_obj_t *msg_count_label, lv_obj_t *state_label);
 
+// 添加MQTT消息（原始载荷，可为二进制；只保存原始数据，显示或点击时才格式化）
+// rx_time_us为收到消息时的esp_timer时间，0表示当前时间
+void mqtt_display_add_raw(const char *topic, const void *payload, size_t payload_len,
+                          int qos, bool retained, int64_t rx_time_us);
+
 // 添加MQTT消息
 void mqtt_display_add_message(const char *topic, const char *message, int qos, bool retained);
 
@@ -17,12 +23,21 @@ void mqtt_display_add_system_msg(const char *message, const char *level);
 // 清空消息
 void mqtt_display_clear(void);
 
+// 设置过滤条件（主题模式支持MQTT通配符'+'/'#'，空字符串或NULL表示不限制）
+void mqtt_display_set_filter(const char *topic_pattern, const char *payload_substr);
+
+// 解析过滤栏输入："主题模式 载荷子串"；单个词含'/'、'+'或'#'时视为主题模式，否则视为载荷子串
+void mqtt_display_set_filter_expr(const char *expr);
+
 // 更新状态
 void mqtt_display_update_state(const char *state);
 
 // 获取消息数量
 uint32_t mqtt_display_get_msg_count(void);
 
+// 获取从收到消息到入库的排队延迟（平均值和最大值，微秒）
+void mqtt_display_get_latency(uint32_t *avg_us, uint32_t *max_us);
+
 // 滚动控制
 void mqtt_display_scroll_to_bottom(void);
 void mqtt_display_scroll_to_top(void);
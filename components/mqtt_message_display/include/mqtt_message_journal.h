@@ -0,0 +1,107 @@
+/**
+ * @file mqtt_message_journal.h
+ * @brief 消息日志的闪存持久化（只追加的分段日志）
+ *
+ * 每条消息以"定长头+主题+载荷"的长度前缀记录写入SPIFFS分区上的分段文件。
+ * 写入由独立任务完成：调用方只把记录放入环形缓冲区（不阻塞），写任务攒满
+ * 一页（JOURNAL_PAGE_SIZE）后整页写入，超时未满时才写入部分页。分段写满后
+ * 在文件尾部追加稀疏索引（每JOURNAL_INDEX_INTERVAL条记录一项）并关闭，超出
+ * 分段数上限时整段删除最旧的文件，因此不存在原地改写和写放大。
+ *
+ * 回看历史时按需从闪存读取：先用分段目录定位分段，再用稀疏索引定位块，
+ * 只读取需要的记录。读取同样在写任务中进行，结果通过轮询取回。
+ */
+
+#ifndef MQTT_MESSAGE_JOURNAL_H
+#define MQTT_MESSAGE_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mqtt_message_store.h"
+
+/**
+ * @defgroup JOURNAL_CONFIG 日志配置
+ * @{
+ */
+#define JOURNAL_PARTITION_LABEL "journal"           ///< SPIFFS分区标签
+#define JOURNAL_BASE_PATH       "/journal"          ///< 挂载路径
+#define JOURNAL_SEGMENT_SIZE    (64 * 1024)         ///< 单个分段文件大小上限
+#define JOURNAL_MAX_SEGMENTS    40                  ///< 分段数上限（超出后删除最旧分段）
+#define JOURNAL_PAGE_SIZE       4096                ///< 写入批量大小（与闪存扇区对齐）
+#define JOURNAL_INDEX_INTERVAL  64                  ///< 稀疏索引间隔（记录数）
+#define JOURNAL_RINGBUF_SIZE    (16 * 1024)         ///< 待写入记录缓冲区大小
+#define JOURNAL_FLUSH_MS        2000                ///< 未满一页时的最长滞留时间
+#define JOURNAL_READ_MAX        32                  ///< 单次回看最多返回的记录数
+#define JOURNAL_SCAN_BLOCKS     64                  ///< 单次回看最多扫描的索引块数
+#define JOURNAL_TASK_STACK      4096                ///< 写任务栈大小
+#define JOURNAL_TASK_PRIORITY   2                   ///< 写任务优先级（低于GUI）
+/** @} */
+
+/**
+ * @brief 回看读取到的记录
+ */
+typedef struct {
+    uint32_t seq;                       ///< 日志序号（跨重启单调递增）
+    int64_t time_ms;                    ///< 接收时间（Unix毫秒）
+    uint8_t qos;                        ///< 服务质量等级
+    uint8_t flags;                      ///< MSG_FLAG_*
+    uint16_t payload_len;               ///< 载荷长度
+    char topic[MSG_STORE_TOPIC_LEN];    ///< 主题
+    uint8_t payload[256];               ///< 载荷（超长部分截断）
+} journal_record_t;
+
+/**
+ * @brief 日志统计
+ */
+typedef struct {
+    uint32_t segments;      ///< 分段数
+    uint32_t first_seq;     ///< 最旧记录序号
+    uint32_t next_seq;      ///< 下一条记录序号
+    uint32_t pages;         ///< 启动以来写入的页数
+    uint32_t dropped;       ///< 因缓冲区满而丢弃的记录数
+} journal_stats_t;
+
+/**
+ * @brief 挂载分区、恢复分段目录并启动写任务
+ * @return true成功，false分区不存在或挂载失败（此时其余接口均为空操作）
+ */
+bool journal_init(void);
+
+/**
+ * @brief 追加一条记录（只复制到环形缓冲区，不阻塞）
+ * @param topic 主题（系统消息为级别字符串）
+ * @param payload 载荷
+ * @param payload_len 载荷长度
+ * @param qos 服务质量等级
+ * @param flags MSG_FLAG_*
+ * @param time_ms 接收时间（Unix毫秒）
+ * @return 分配的日志序号，日志不可用时返回MSG_STORE_SEQ_NONE
+ *         （缓冲区满时记录被丢弃，但序号照常分配）
+ */
+uint32_t journal_append(const char *topic, const void *payload, size_t payload_len,
+                        int qos, uint8_t flags, int64_t time_ms);
+
+/**
+ * @brief 请求回看：读取序号小于before_seq且满足过滤条件的最新max条记录
+ * @param before_seq 序号上界（不含）
+ * @param max 最多读取的条数（不超过JOURNAL_READ_MAX）
+ * @param filter 过滤条件，NULL表示不过滤
+ * @return true请求已提交，false日志不可用或上一个请求尚未完成
+ */
+bool journal_request_before(uint32_t before_seq, size_t max, const msg_filter_t *filter);
+
+/**
+ * @brief 取回已完成的回看结果
+ * @param[out] count 结果条数
+ * @param[out] exhausted 是否已读到日志开头
+ * @return 结果数组（按从旧到新排列，在下一次请求前有效）；请求未完成时返回NULL
+ */
+const journal_record_t *journal_take_result(size_t *count, bool *exhausted);
+
+/**
+ * @brief 获取统计信息
+ */
+void journal_get_stats(journal_stats_t *stats);
+
+#endif
@@ -0,0 +1,173 @@
+/**
+ * @file mqtt_message_store.h
+ * @brief MQTT消息存储与增量索引
+ *
+ * 以环形结构保存最近收到的消息（主题+载荷原始数据+元信息），并在消息到达时
+ * 增量维护主题索引：每个主题分配一个主题ID，每条记录保存同主题上一条记录的
+ * 序号，构成按主题的倒排链（postings list）。过滤查询只需沿匹配主题的倒排链
+ * 归并，无需逐条扫描全部历史。
+ */
+
+#ifndef MQTT_MESSAGE_STORE_H
+#define MQTT_MESSAGE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @defgroup MSG_STORE_CONFIG 存储配置
+ * @{
+ */
+#define MSG_STORE_CAPACITY    1024          ///< 记录容量（必须为2的幂）
+#define MSG_STORE_ARENA_SIZE  (96 * 1024)   ///< 主题+载荷环形数据区大小（字节）
+#define MSG_STORE_MAX_TOPICS  64            ///< 索引的主题数量上限（与64位主题位图对应）
+#define MSG_STORE_TOPIC_LEN   64            ///< 主题字符串最大长度（含结束符）
+#define MSG_STORE_PATTERN_LEN 64            ///< 过滤条件字符串最大长度（含结束符）
+/** @} */
+
+#define MSG_STORE_SEQ_NONE    0             ///< 无效序号（有效序号从1开始）
+
+#define MSG_FLAG_RETAINED     (1 << 0)      ///< 保留消息
+#define MSG_FLAG_SYSTEM       (1 << 1)      ///< 系统消息（主题字段保存级别字符串）
+
+/**
+ * @brief 消息记录（仅元信息，主题和载荷位于数据区）
+ */
+typedef struct {
+    uint32_t seq;              ///< 全局序号
+    uint32_t prev_same_topic;  ///< 同主题上一条记录的序号（倒排链）
+    uint32_t data_off;         ///< 主题+载荷在数据区中的偏移
+    uint16_t topic_len;        ///< 主题长度（不含结束符）
+    uint16_t payload_len;      ///< 载荷长度
+    uint8_t topic_id;          ///< 主题ID
+    uint8_t qos;               ///< 服务质量等级
+    uint8_t flags;             ///< MSG_FLAG_*
+    int64_t rx_time_us;        ///< 接收时间（esp_timer时间，微秒）
+} msg_record_t;
+
+/**
+ * @brief 过滤条件
+ *
+ * 两个条件同时生效（与关系），空字符串表示不限制。
+ * 主题条件使用MQTT订阅通配符语义（'+'匹配单层，'#'匹配剩余所有层）。
+ */
+typedef struct {
+    char topic_pattern[MSG_STORE_PATTERN_LEN];   ///< 主题过滤模式
+    char payload_substr[MSG_STORE_PATTERN_LEN];  ///< 载荷子串
+} msg_filter_t;
+
+/**
+ * @brief 初始化消息存储（分配记录表和数据区，优先使用PSRAM）
+ * @return true成功，false内存不足
+ */
+bool msg_store_init(void);
+
+/**
+ * @brief 清空所有记录和主题索引
+ */
+void msg_store_clear(void);
+
+/**
+ * @brief 追加一条记录并更新索引
+ * @param topic 主题（系统消息为级别字符串）
+ * @param payload 载荷数据
+ * @param payload_len 载荷长度
+ * @param qos 服务质量等级
+ * @param flags MSG_FLAG_*
+ * @param rx_time_us 接收时间（esp_timer时间，微秒）
+ * @return 新记录的序号，失败返回MSG_STORE_SEQ_NONE
+ */
+uint32_t msg_store_append(const char *topic, const void *payload, size_t payload_len,
+                          int qos, uint8_t flags, int64_t rx_time_us);
+
+/**
+ * @brief 按序号读取记录
+ * @param seq 记录序号
+ * @param[out] rec 记录元信息
+ * @param[out] topic 主题缓冲区（至少MSG_STORE_TOPIC_LEN字节），可为NULL
+ * @param[out] payload 载荷缓冲区，可为NULL
+ * @param payload_size 载荷缓冲区大小，载荷超长时截断
+ * @return true记录仍在存储中，false已被淘汰或不存在
+ */
+bool msg_store_get(uint32_t seq, msg_record_t *rec, char *topic,
+                   uint8_t *payload, size_t payload_size);
+
+/**
+ * @brief 编译过滤条件（计算匹配的主题位图），设置后用于查询和增量匹配
+ * @param filter 过滤条件，NULL表示清除过滤
+ */
+void msg_store_set_filter(const msg_filter_t *filter);
+
+/**
+ * @brief 当前是否设置了过滤条件
+ */
+bool msg_store_filter_active(void);
+
+/**
+ * @brief 获取当前过滤条件的副本
+ * @param[out] filter 过滤条件
+ */
+void msg_store_get_filter(msg_filter_t *filter);
+
+/**
+ * @brief 判断一条不在存储中的消息（如闪存日志中的记录）是否满足过滤条件
+ * @param filter 过滤条件
+ * @param topic 主题
+ * @param topic_len 主题长度
+ * @param payload 载荷
+ * @param payload_len 载荷长度
+ * @param flags MSG_FLAG_*
+ * @return true满足
+ */
+bool msg_filter_matches(const msg_filter_t *filter, const char *topic, size_t topic_len,
+                        const uint8_t *payload, size_t payload_len, uint8_t flags);
+
+/**
+ * @brief 判断指定记录是否满足当前过滤条件
+ * @param seq 记录序号
+ * @return true满足（未设置过滤时总是满足）
+ */
+bool msg_store_match(uint32_t seq);
+
+/**
+ * @brief 按当前过滤条件查询最新的匹配记录
+ * @param[out] out_seqs 结果序号数组，按从新到旧排列
+ * @param max_results 最多返回的条数
+ * @return 实际返回的条数
+ */
+size_t msg_store_query(uint32_t *out_seqs, size_t max_results);
+
+/**
+ * @brief 列出存储中仍有记录的主题（不含系统消息和溢出桶），按最近活跃程度排序
+ * @param[out] names 主题名数组
+ * @param max_topics 数组容量
+ * @return 实际返回的主题数
+ */
+size_t msg_store_list_topics(char (*names)[MSG_STORE_TOPIC_LEN], size_t max_topics);
+
+/**
+ * @brief 沿倒排链查询指定主题的历史记录（不受当前过滤条件影响）
+ * @param topic 主题（精确匹配）
+ * @param[out] out_seqs 结果序号数组，按从新到旧排列
+ * @param max_results 最多返回的条数
+ * @return 实际返回的条数
+ */
+size_t msg_store_topic_history(const char *topic, uint32_t *out_seqs, size_t max_results);
+
+/**
+ * @brief 获取存储中最旧/最新记录的序号
+ */
+uint32_t msg_store_oldest_seq(void);
+uint32_t msg_store_newest_seq(void);
+
+/**
+ * @brief MQTT主题通配符匹配
+ * @param pattern 订阅模式（支持'+'和'#'）
+ * @param topic 主题
+ * @param topic_len 主题长度
+ * @return true匹配
+ */
+bool msg_topic_matches(const char *pattern, const char *topic, size_t topic_len);
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file mqtt_payload_format.h
+ * @brief MQTT载荷按需格式化
+ *
+ * 消息以原始字节保存在消息存储中，只有在某一行需要显示或被点击展开时才进行
+ * 格式化（JSON美化、二进制十六进制转储、截断）。格式化结果保存在一个小型
+ * LRU缓存中，同一条消息重复显示时无需再次格式化。
+ *
+ * @note 所有接口只能在LVGL上下文（持有LVGL锁）中调用。
+ */
+
+#ifndef MQTT_PAYLOAD_FORMAT_H
+#define MQTT_PAYLOAD_FORMAT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mqtt_message_store.h"
+
+/**
+ * @defgroup MSG_FORMAT_CONFIG 格式化配置
+ * @{
+ */
+#define MSG_FMT_LINE_LEN        160     ///< 单行预览最大长度（含结束符）
+#define MSG_FMT_DETAIL_LEN      2048    ///< 展开详情最大长度（含结束符）
+#define MSG_FMT_LINE_SLOTS      48      ///< 单行预览缓存条数
+#define MSG_FMT_DETAIL_SLOTS    4       ///< 展开详情缓存条数
+#define MSG_FMT_HEX_PER_LINE    8       ///< 十六进制转储每行字节数
+#define MSG_FMT_JSON_INDENT     2       ///< JSON美化缩进空格数
+/** @} */
+
+/**
+ * @brief 载荷内容类型
+ */
+typedef enum {
+    MSG_PAYLOAD_TEXT = 0,   ///< 可打印文本
+    MSG_PAYLOAD_JSON,       ///< JSON对象或数组
+    MSG_PAYLOAD_BINARY,     ///< 二进制数据
+} msg_payload_kind_t;
+
+/**
+ * @brief 初始化格式化缓存（缓存区优先分配在PSRAM）
+ * @return true成功，false内存不足
+ */
+bool msg_format_init(void);
+
+/**
+ * @brief 清空格式化缓存（消息存储被清空时调用）
+ */
+void msg_format_invalidate(void);
+
+/**
+ * @brief 把接收时间（esp_timer时间）换算为墙上时间
+ * @param rx_time_us 接收时间（微秒）
+ * @return 墙上时间（Unix毫秒）
+ */
+int64_t msg_format_wall_ms(int64_t rx_time_us);
+
+/**
+ * @brief 获取一条消息的单行预览（带缓存）
+ *
+ * 格式："[序号] 时:分:秒.毫秒 [Q等级R] 主题: 载荷预览"，系统消息为
+ * "[SYS] 时:分:秒.毫秒 [级别] 内容"。载荷中的换行被替换为空格，超长部分截断。
+ *
+ * @param seq 记录序号
+ * @return 预览字符串（不含换行），记录已被淘汰时返回NULL。
+ *         返回的指针在下一次调用格式化接口前有效。
+ */
+const char *msg_format_line(uint32_t seq);
+
+/**
+ * @brief 设置单行预览的显示序号偏移
+ *
+ * 存储序号每次启动从头计数，闪存日志可用时加上日志序号与存储序号之差，
+ * 使实时消息与回看记录使用同一套编号。偏移变化时清空单行预览缓存。
+ *
+ * @param offset 显示序号 = 存储序号 + offset
+ */
+void msg_format_set_seq_offset(int32_t offset);
+
+/**
+ * @brief 按单行预览格式格式化一条不在消息存储中的记录（如闪存日志回看结果，不缓存）
+ * @param rec 记录（使用seq、qos、flags、payload_len字段）
+ * @param wall_ms 接收时间（Unix毫秒）
+ * @param topic 主题
+ * @param payload 载荷数据
+ * @param len payload中可用的字节数（小于rec->payload_len时视为截断）
+ * @param[out] out 输出缓冲区
+ * @param size 输出缓冲区大小
+ */
+void msg_format_record_line(const msg_record_t *rec, int64_t wall_ms, const char *topic,
+                            const uint8_t *payload, size_t len, char *out, size_t size);
+
+/**
+ * @brief 获取一条消息的展开详情（带缓存）
+ *
+ * 首行为接收时间及与同主题上一条消息的间隔。其后JSON载荷缩进美化，二进制载荷
+ * 输出"偏移 十六进制 |ASCII|"转储，文本原样输出，超过MSG_FMT_DETAIL_LEN的部分截断。
+ *
+ * @param seq 记录序号
+ * @param[out] topic 主题缓冲区（至少MSG_STORE_TOPIC_LEN字节），可为NULL
+ * @return 详情字符串，记录已被淘汰时返回NULL。
+ *         返回的指针在下一次调用格式化接口前有效。
+ */
+const char *msg_format_detail(uint32_t seq, char *topic);
+
+/**
+ * @brief 判断载荷类型
+ * @param data 载荷数据
+ * @param len 载荷长度
+ * @return 载荷类型
+ */
+msg_payload_kind_t msg_payload_classify(const uint8_t *data, size_t len);
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file mqtt_topic_series.h
+ * @brief 单主题数值序列（图表数据源）
+ *
+ * 对选中主题的载荷解析出数值（纯数字或JSON字段），写入固定容量的环形缓冲区。
+ * 绘图时将缓冲区降采样为固定点数（LTTB或最小/最大值分桶），因此无论主题
+ * 消息频率多高，内存占用和每帧绘制开销都是常数。
+ *
+ * @note 所有接口只能在LVGL上下文（持有LVGL锁）中调用。
+ */
+
+#ifndef MQTT_TOPIC_SERIES_H
+#define MQTT_TOPIC_SERIES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @defgroup SERIES_CONFIG 序列配置
+ * @{
+ */
+#define SERIES_CAPACITY     4096    ///< 环形缓冲区样本数（必须为2的幂）
+#define SERIES_FIELD_LEN    32      ///< JSON字段名最大长度（含结束符）
+#define SERIES_MAX_KEYS     8       ///< 列出的JSON数值字段数上限
+/** @} */
+
+/**
+ * @brief 降采样算法
+ */
+typedef enum {
+    SERIES_DECIMATE_LTTB = 0,   ///< Largest-Triangle-Three-Buckets，保留形状
+    SERIES_DECIMATE_MINMAX,     ///< 每桶输出最小值和最大值，保留峰值
+} series_decimate_t;
+
+/**
+ * @brief 序列统计信息
+ */
+typedef struct {
+    float last;         ///< 最新值
+    float min;          ///< 缓冲区内最小值
+    float max;          ///< 缓冲区内最大值
+    float rate_hz;      ///< 缓冲区内平均采样频率
+    uint32_t count;     ///< 缓冲区内样本数
+    uint32_t total;     ///< 选中以来累计样本数
+} series_stats_t;
+
+/**
+ * @brief 初始化序列缓冲区（优先使用PSRAM）
+ * @return true成功，false内存不足
+ */
+bool series_init(void);
+
+/**
+ * @brief 选择要绘制的主题和字段，清空缓冲区并从消息存储中回填历史数据
+ * @param topic 主题（精确匹配），NULL或空字符串表示不绘制
+ * @param field JSON字段名，NULL或空字符串表示自动（纯数字或第一个数值字段）
+ */
+void series_select(const char *topic, const char *field);
+
+/**
+ * @brief 获取当前选中的主题和字段
+ */
+const char *series_topic(void);
+const char *series_field(void);
+
+/**
+ * @brief 输入一条消息（非选中主题直接忽略）
+ * @param topic 主题
+ * @param payload 载荷
+ * @param len 载荷长度
+ * @param rx_time_us 接收时间（esp_timer时间，微秒）
+ */
+void series_feed(const char *topic, const void *payload, size_t len, int64_t rx_time_us);
+
+/**
+ * @brief 自上次series_render以来是否有新样本
+ */
+bool series_dirty(void);
+
+/**
+ * @brief 标记需要重绘（缓冲区内容不变，例如切换了降采样算法）
+ */
+void series_invalidate(void);
+
+/**
+ * @brief 将缓冲区降采样为最多max_points个点
+ * @param[out] out 输出数值（按时间顺序）
+ * @param max_points 输出点数上限（MINMAX模式下为偶数更佳）
+ * @param mode 降采样算法
+ * @param[out] stats 统计信息，可为NULL
+ * @return 实际输出的点数
+ */
+size_t series_render(float *out, size_t max_points, series_decimate_t mode, series_stats_t *stats);
+
+/**
+ * @brief 从载荷中解析数值
+ * @param payload 载荷
+ * @param len 载荷长度
+ * @param field JSON字段名（在任意层级首次出现的同名键），NULL或空字符串表示自动
+ * @param[out] value 解析结果
+ * @return true解析成功
+ */
+bool series_parse_value(const uint8_t *payload, size_t len, const char *field, float *value);
+
+/**
+ * @brief 列出JSON载荷中值为数字的字段名（去重，按出现顺序）
+ * @param payload 载荷
+ * @param len 载荷长度
+ * @param[out] keys 字段名数组
+ * @param max_keys 数组容量
+ * @return 字段数
+ */
+size_t series_numeric_keys(const uint8_t *payload, size_t len,
+                           char (*keys)[SERIES_FIELD_LEN], size_t max_keys);
+
+#endif
@@ -0,0 +1,262 @@
+#include "mqtt_chart_display.h"
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mqtt_message_store.h"
+#include "mqtt_topic_series.h"
+
+static const char *TAG = "MQTT_CHART";
+
+// 内部变量
+static lv_obj_t *g_chart = NULL;
+static lv_obj_t *g_topic_dd = NULL;
+static lv_obj_t *g_field_dd = NULL;
+static lv_obj_t *g_mode_dd = NULL;
+static lv_obj_t *g_stats_label = NULL;
+static lv_chart_series_t *g_series = NULL;
+static lv_timer_t *refresh_timer = NULL;
+static series_decimate_t decimate_mode = SERIES_DECIMATE_LTTB;
+
+static float chart_values[CHART_POINTS];
+static lv_coord_t chart_points[CHART_POINTS];
+
+// 在下拉框选项中查找文本，返回下标，未找到返回-1
+static int dropdown_find(lv_obj_t *dd, const char *text) {
+    const char *opts = lv_dropdown_get_options(dd);
+    size_t len = strlen(text);
+    int idx = 0;
+
+    while (opts && *opts) {
+        const char *nl = strchr(opts, '\n');
+        size_t opt_len = nl ? (size_t)(nl - opts) : strlen(opts);
+        if (opt_len == len && strncmp(opts, text, len) == 0) {
+            return idx;
+        }
+        if (!nl) {
+            break;
+        }
+        opts = nl + 1;
+        idx++;
+    }
+    return -1;
+}
+
+// 根据主题最新一条载荷刷新字段下拉列表
+static void refresh_fields(void) {
+    char keys[SERIES_MAX_KEYS][SERIES_FIELD_LEN];
+    char opts[16 + SERIES_MAX_KEYS * SERIES_FIELD_LEN];
+    uint8_t payload[256];
+    msg_record_t rec;
+    uint32_t seq;
+    size_t n = 0;
+
+    if (!g_field_dd) {
+        return;
+    }
+    if (series_topic()[0] != '\0' && msg_store_topic_history(series_topic(), &seq, 1) == 1 &&
+        msg_store_get(seq, &rec, NULL, payload, sizeof(payload))) {
+        size_t len = rec.payload_len < sizeof(payload) ? rec.payload_len : sizeof(payload);
+        n = series_numeric_keys(payload, len, keys, SERIES_MAX_KEYS);
+    }
+
+    strcpy(opts, "auto");
+    for (size_t i = 0; i < n; i++) {
+        strcat(opts, "\n");
+        strcat(opts, keys[i]);
+    }
+    lv_dropdown_set_options(g_field_dd, opts);
+    int sel = series_field()[0] ? dropdown_find(g_field_dd, series_field()) : 0;
+    lv_dropdown_set_selected(g_field_dd, sel > 0 ? sel : 0);
+}
+
+// 周期刷新：有新样本时降采样并重绘（图表界面不显示时定时器暂停）
+static void refresh_timer_cb(lv_timer_t *timer) {
+    series_stats_t stats;
+    char text[96];
+
+    if (!g_chart || lv_obj_get_screen(g_chart) != lv_scr_act() || !series_dirty()) {
+        return;
+    }
+
+    size_t n = series_render(chart_values, CHART_POINTS, decimate_mode, &stats);
+    float lo = stats.min, hi = stats.max;
+    if (hi - lo < 1e-6f) {
+        lo -= 1.0f;
+        hi += 1.0f;
+    }
+    for (size_t i = 0; i < n; i++) {
+        chart_points[i] = (lv_coord_t)((chart_values[i] - lo) * CHART_Y_SCALE / (hi - lo));
+    }
+    lv_chart_set_point_count(g_chart, n > 0 ? n : 1);
+    if (n == 0) {
+        chart_points[0] = LV_CHART_POINT_NONE;
+    }
+    lv_chart_refresh(g_chart);
+
+    if (g_stats_label) {
+        if (stats.count > 0) {
+            snprintf(text, sizeof(text), "last %.3g  min %.3g  max %.3g  %.1fHz  n=%lu",
+                     stats.last, stats.min, stats.max, stats.rate_hz, (unsigned long)stats.total);
+        } else {
+            snprintf(text, sizeof(text), "no numeric data");
+        }
+        lv_label_set_text(g_stats_label, text);
+    }
+}
+
+// 图表界面显示时恢复刷新定时器，切走后暂停，避免界面不可见时周期唤醒LVGL任务
+static void chart_screen_cb(lv_event_t *e) {
+    if (refresh_timer == NULL) {
+        return;
+    }
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_SCREEN_LOADED) {
+        lv_timer_resume(refresh_timer);
+        lv_timer_ready(refresh_timer);
+    } else if (code == LV_EVENT_SCREEN_UNLOADED) {
+        lv_timer_pause(refresh_timer);
+    }
+}
+
+static void topic_dd_cb(lv_event_t *e) {
+    char topic[MSG_STORE_TOPIC_LEN];
+    lv_dropdown_get_selected_str(g_topic_dd, topic, sizeof(topic));
+    series_select(topic, NULL);
+    refresh_fields();
+}
+
+static void field_dd_cb(lv_event_t *e) {
+    char field[SERIES_FIELD_LEN];
+    if (lv_dropdown_get_selected(g_field_dd) == 0) {
+        field[0] = '\0';
+    } else {
+        lv_dropdown_get_selected_str(g_field_dd, field, sizeof(field));
+    }
+    series_select(series_topic(), field);
+}
+
+static void mode_dd_cb(lv_event_t *e) {
+    decimate_mode = lv_dropdown_get_selected(g_mode_dd) == 1 ? SERIES_DECIMATE_MINMAX : SERIES_DECIMATE_LTTB;
+    series_invalidate();
+}
+
+// 绑定图表界面组件
+void mqtt_chart_bind(lv_obj_t *chart, lv_obj_t *topic_dd, lv_obj_t *field_dd,
+                     lv_obj_t *mode_dd, lv_obj_t *stats_label) {
+    if (!chart || !topic_dd) {
+        ESP_LOGE(TAG, "图表对象不能为空");
+        return;
+    }
+    if (!series_init()) {
+        return;
+    }
+
+    g_chart = chart;
+    g_topic_dd = topic_dd;
+    g_field_dd = field_dd;
+    g_mode_dd = mode_dd;
+    g_stats_label = stats_label;
+
+    lv_chart_set_type(g_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_range(g_chart, LV_CHART_AXIS_PRIMARY_Y, 0, CHART_Y_SCALE);
+    lv_chart_set_div_line_count(g_chart, 5, 0);
+    lv_obj_set_style_size(g_chart, 0, LV_PART_INDICATOR);   // 不绘制数据点，只画折线
+    g_series = lv_chart_add_series(g_chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+    lv_chart_set_ext_y_array(g_chart, g_series, chart_points);
+    lv_chart_set_point_count(g_chart, 1);
+    chart_points[0] = LV_CHART_POINT_NONE;
+
+    lv_obj_add_event_cb(g_topic_dd, topic_dd_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    if (g_field_dd) {
+        lv_obj_add_event_cb(g_field_dd, field_dd_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    }
+    if (g_mode_dd) {
+        lv_dropdown_set_options(g_mode_dd, "LTTB\nMin/Max");
+        lv_dropdown_set_selected(g_mode_dd, decimate_mode == SERIES_DECIMATE_MINMAX ? 1 : 0);
+        lv_obj_add_event_cb(g_mode_dd, mode_dd_cb, LV_EVENT_VALUE_CHANGED, NULL);
+    }
+
+    if (refresh_timer == NULL) {
+        refresh_timer = lv_timer_create(refresh_timer_cb, CHART_REFRESH_MS, NULL);
+    }
+    lv_obj_t *screen = lv_obj_get_screen(g_chart);
+    lv_obj_add_event_cb(screen, chart_screen_cb, LV_EVENT_ALL, NULL);
+    if (screen != lv_scr_act()) {
+        lv_timer_pause(refresh_timer);
+    }
+    mqtt_chart_refresh_topics();
+    ESP_LOGI(TAG, "图表绑定成功");
+}
+
+// 解除绑定
+void mqtt_chart_unbind(void) {
+    if (refresh_timer) {
+        lv_timer_del(refresh_timer);
+        refresh_timer = NULL;
+    }
+    if (g_chart) {
+        lv_obj_remove_event_cb(lv_obj_get_screen(g_chart), chart_screen_cb);
+    }
+    g_chart = NULL;
+    g_topic_dd = NULL;
+    g_field_dd = NULL;
+    g_mode_dd = NULL;
+    g_stats_label = NULL;
+    g_series = NULL;
+}
+
+// 刷新主题下拉列表
+void mqtt_chart_refresh_topics(void) {
+    if (!g_topic_dd) {
+        return;
+    }
+    char (*names)[MSG_STORE_TOPIC_LEN] = heap_caps_malloc(MSG_STORE_MAX_TOPICS * MSG_STORE_TOPIC_LEN,
+                                                         MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    char *opts = heap_caps_malloc(MSG_STORE_MAX_TOPICS * MSG_STORE_TOPIC_LEN, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (names == NULL || opts == NULL) {
+        heap_caps_free(names);
+        heap_caps_free(opts);
+        return;
+    }
+
+    size_t n = msg_store_list_topics(names, MSG_STORE_MAX_TOPICS);
+    opts[0] = '\0';
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            strcat(opts, "\n");
+        }
+        strcat(opts, names[i]);
+    }
+    lv_dropdown_set_options(g_topic_dd, n > 0 ? opts : "(no topics)");
+    heap_caps_free(names);
+    heap_caps_free(opts);
+
+    if (n == 0) {
+        return;
+    }
+    int sel = series_topic()[0] ? dropdown_find(g_topic_dd, series_topic()) : -1;
+    if (sel < 0) {
+        // 当前没有选中主题或主题已被淘汰，默认选中最活跃的主题
+        lv_dropdown_set_selected(g_topic_dd, 0);
+        lv_event_send(g_topic_dd, LV_EVENT_VALUE_CHANGED, NULL);
+    } else {
+        lv_dropdown_set_selected(g_topic_dd, sel);
+        refresh_fields();
+    }
+}
+
+// 指定绘制的主题和字段
+void mqtt_chart_select(const char *topic, const char *field) {
+    if (!series_init()) {
+        return;
+    }
+    series_select(topic, field);
+    if (g_topic_dd) {
+        int sel = dropdown_find(g_topic_dd, topic);
+        if (sel >= 0) {
+            lv_dropdown_set_selected(g_topic_dd, sel);
+        }
+        refresh_fields();
+    }
+}
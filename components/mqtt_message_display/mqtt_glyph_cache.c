@@ -0,0 +1,174 @@
+#include "mqtt_glyph_cache.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "GLYPH_CACHE";
+
+#define GLYPH_COUNT (GLYPH_CACHE_LAST - GLYPH_CACHE_FIRST + 1)
+
+/**
+ * @brief 缓存的字形参数
+ */
+typedef struct {
+    uint32_t bitmap_off;  ///< 8位位图在s_bitmaps中的偏移
+    uint8_t adv_w;        ///< 不含字距调整的步进宽度（像素）
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;
+} glyph_entry_t;
+
+/**
+ * @brief 字距调整对（左字符的所有调整对连续存放，按右字符升序）
+ */
+typedef struct {
+    uint8_t right;  ///< 右字符
+    int8_t delta;   ///< 步进宽度的调整量（像素）
+} kern_pair_t;
+
+static lv_font_t s_font;
+static const lv_font_t *s_base = NULL;
+static glyph_entry_t s_glyphs[GLYPH_COUNT];
+static uint16_t s_kern_start[GLYPH_COUNT + 1];  ///< 每个左字符的调整对在s_kerns中的起止位置
+static kern_pair_t *s_kerns = NULL;
+static uint8_t *s_bitmaps = NULL;
+
+static inline bool in_range(uint32_t letter) {
+    return letter >= GLYPH_CACHE_FIRST && letter <= GLYPH_CACHE_LAST;
+}
+
+static int8_t kern_lookup(uint32_t left, uint32_t right) {
+    const kern_pair_t *p = s_kerns + s_kern_start[left - GLYPH_CACHE_FIRST];
+    const kern_pair_t *end = s_kerns + s_kern_start[left - GLYPH_CACHE_FIRST + 1];
+
+    for (; p < end && p->right <= right; p++) {
+        if (p->right == right) {
+            return p->delta;
+        }
+    }
+    return 0;
+}
+
+static bool cache_get_glyph_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+                                uint32_t letter_next) {
+    if (!in_range(letter)) {
+        return false;  // 由fallback（基础字体）处理
+    }
+    const glyph_entry_t *g = &s_glyphs[letter - GLYPH_CACHE_FIRST];
+    dsc_out->adv_w = g->adv_w + (in_range(letter_next) ? kern_lookup(letter, letter_next) : 0);
+    dsc_out->box_w = g->box_w;
+    dsc_out->box_h = g->box_h;
+    dsc_out->ofs_x = g->ofs_x;
+    dsc_out->ofs_y = g->ofs_y;
+    dsc_out->bpp = 8;
+    dsc_out->is_placeholder = false;
+    return true;
+}
+
+static const uint8_t *cache_get_glyph_bitmap(const lv_font_t *font, uint32_t letter) {
+    if (!in_range(letter)) {
+        return NULL;
+    }
+    return s_bitmaps + s_glyphs[letter - GLYPH_CACHE_FIRST].bitmap_off;
+}
+
+// 把1/2/4/8位的紧凑位图展开为每像素一个字节
+static void expand_bitmap(uint8_t *dst, const uint8_t *src, uint32_t px_cnt, uint8_t bpp) {
+    uint32_t max = (1 << bpp) - 1;
+
+    for (uint32_t i = 0; i < px_cnt; i++) {
+        uint32_t bit = i * bpp;
+        uint32_t v = (src[bit >> 3] >> (8 - bpp - (bit & 7))) & max;
+        dst[i] = (uint8_t)(v * 255 / max);
+    }
+}
+
+const lv_font_t *glyph_cache_create(const lv_font_t *base) {
+    lv_font_glyph_dsc_t dsc;
+    size_t bitmap_size = 0;
+    size_t kern_cnt = 0;
+
+    if (s_base != NULL) {
+        return (s_base == base) ? &s_font : base;
+    }
+
+    // 第一遍：字形参数、位图总大小和字距调整对数量
+    for (uint32_t c = GLYPH_CACHE_FIRST; c <= GLYPH_CACHE_LAST; c++) {
+        glyph_entry_t *g = &s_glyphs[c - GLYPH_CACHE_FIRST];
+        if (!base->get_glyph_dsc(base, &dsc, c, 0) || dsc.is_placeholder) {
+            memset(g, 0, sizeof(*g));  // 基础字体中没有的字符显示为空白
+            continue;
+        }
+        uint8_t bpp = (dsc.bpp == 3) ? 4 : dsc.bpp;  // 与lv_draw_sw_letter一致
+        if (bpp != 1 && bpp != 2 && bpp != 4 && bpp != 8) {
+            ESP_LOGW(TAG, "不支持的字形格式(bpp=%u)，使用基础字体", dsc.bpp);
+            return base;
+        }
+        g->bitmap_off = bitmap_size;
+        g->adv_w = dsc.adv_w;
+        g->box_w = dsc.box_w;
+        g->box_h = dsc.box_h;
+        g->ofs_x = dsc.ofs_x;
+        g->ofs_y = dsc.ofs_y;
+        bitmap_size += dsc.box_w * dsc.box_h;
+        for (uint32_t n = GLYPH_CACHE_FIRST; n <= GLYPH_CACHE_LAST; n++) {
+            lv_font_glyph_dsc_t kd;
+            if (base->get_glyph_dsc(base, &kd, c, n) && kd.adv_w != dsc.adv_w) {
+                kern_cnt++;
+            }
+        }
+    }
+
+    // 内部RAM：绘制每个字符都要读取，放在PSRAM中反而更慢
+    s_bitmaps = heap_caps_malloc(bitmap_size ? bitmap_size : 1, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    s_kerns = heap_caps_malloc((kern_cnt ? kern_cnt : 1) * sizeof(kern_pair_t), MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    if (s_bitmaps == NULL || s_kerns == NULL) {
+        heap_caps_free(s_bitmaps);
+        heap_caps_free(s_kerns);
+        s_bitmaps = NULL;
+        s_kerns = NULL;
+        ESP_LOGW(TAG, "字形缓存内存不足(%u字节)，使用基础字体", (unsigned)(bitmap_size + kern_cnt * sizeof(kern_pair_t)));
+        return base;
+    }
+
+    // 第二遍：展开位图，记录字距调整对
+    kern_cnt = 0;
+    for (uint32_t c = GLYPH_CACHE_FIRST; c <= GLYPH_CACHE_LAST; c++) {
+        const glyph_entry_t *g = &s_glyphs[c - GLYPH_CACHE_FIRST];
+        s_kern_start[c - GLYPH_CACHE_FIRST] = kern_cnt;
+        if (!base->get_glyph_dsc(base, &dsc, c, 0) || dsc.is_placeholder) {
+            continue;
+        }
+        // 空格等没有位图的字符只跳过位图，步进宽度和字距调整照常记录
+        if (g->box_w > 0 && g->box_h > 0) {
+            const uint8_t *src = base->get_glyph_bitmap(base, c);
+            if (src != NULL) {
+                expand_bitmap(s_bitmaps + g->bitmap_off, src, g->box_w * g->box_h, (dsc.bpp == 3) ? 4 : dsc.bpp);
+            } else {
+                memset(s_bitmaps + g->bitmap_off, 0, g->box_w * g->box_h);
+            }
+        }
+        for (uint32_t n = GLYPH_CACHE_FIRST; n <= GLYPH_CACHE_LAST; n++) {
+            lv_font_glyph_dsc_t kd;
+            if (base->get_glyph_dsc(base, &kd, c, n) && kd.adv_w != dsc.adv_w) {
+                s_kerns[kern_cnt].right = n;
+                s_kerns[kern_cnt].delta = (int8_t)(kd.adv_w - dsc.adv_w);
+                kern_cnt++;
+            }
+        }
+    }
+    s_kern_start[GLYPH_COUNT] = kern_cnt;
+
+    // 行高、基线等与基础字体相同，范围外的字符交给基础字体
+    s_font = *base;
+    s_font.get_glyph_dsc = cache_get_glyph_dsc;
+    s_font.get_glyph_bitmap = cache_get_glyph_bitmap;
+    s_font.dsc = NULL;
+    s_font.fallback = base;
+    s_base = base;
+
+    ESP_LOGI(TAG, "字形缓存已建立: %d个字符, 位图%u字节, 字距%u对",
+             GLYPH_COUNT, (unsigned)bitmap_size, (unsigned)kern_cnt);
+    return &s_font;
+}
@@ -3,6 +3,12 @@
 #include <stdio.h>
 #include <time.h>
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_glyph_cache.h"
+#include "mqtt_message_journal.h"
+#include "mqtt_message_store.h"
+#include "mqtt_payload_format.h"
+#include "mqtt_topic_series.h"
 
 static const char *TAG = "MQTT_DISPLAY";
 
@@ -10,16 +16,40 @@ static const char *TAG = "MQTT_DISPLAY";
 static lv_obj_t *g_textarea = NULL;
 static lv_obj_t *g_msg_count_label = NULL;
 static lv_obj_t *g_state_label = NULL;
-static char message_buffer[8192];
+#define DISPLAY_MAX_LINES 40                      ///< 文本框中显示的最大行数
+#define DISPLAY_RENDER_PERIOD_MS 100              ///< 视图刷新周期（毫秒）
+#define DISPLAY_HISTORY_BATCH 16                  ///< 每次回看从闪存日志读取的条数
+#define DISPLAY_HISTORY_LINES 96                  ///< 回看区最大行数
+#define DISPLAY_HISTORY_BUF_SIZE 6144             ///< 回看区文本缓冲区大小
+#define DISPLAY_SCROLL_EDGE_PX 4                  ///< 判定滚动到顶部/底部的容差（像素）
+
+static char message_buffer[8192 + DISPLAY_HISTORY_BUF_SIZE];
 static uint32_t message_count = 0;
 static bool auto_scroll_enabled = true;
 
-// 获取当前时间字符串
-static void get_time_string(char *buffer, size_t size) {
-    time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
-    strftime(buffer, size, "%H:%M:%S", tm_info);
-}
+static uint32_t view_seqs[DISPLAY_MAX_LINES];    ///< 当前视图中的记录序号（从旧到新）
+static size_t view_len = 0;
+static bool view_dirty = false;                  ///< 视图有变化，等待下一次刷新
+static bool count_dirty = false;                 ///< 消息计数有变化
+static lv_timer_t *render_timer = NULL;
+
+// 回看区：视图上方从闪存日志读取的更早记录（只读文本，不可点击展开）
+static char history_text[DISPLAY_HISTORY_BUF_SIZE];
+static size_t history_len = 0;
+static uint32_t history_seqs[DISPLAY_HISTORY_LINES];   ///< 回看区每行的日志序号（从旧到新）
+static size_t history_lines = 0;
+static bool history_pending = false;             ///< 回看请求已提交，等待结果
+static bool history_stale = false;               ///< 等待中的结果已过期（过滤条件变化或清空）
+static bool history_exhausted = false;           ///< 已读到日志开头或回看区已满
+static int32_t journal_offset = 0;               ///< 日志序号与存储序号之差
+
+static uint32_t latency_avg_us = 0;              ///< 排队延迟的指数滑动平均
+static uint32_t latency_max_us = 0;
+
+static void render_timer_cb(lv_timer_t *timer);
+static void render_wake(void);
+static void textarea_click_cb(lv_event_t *e);
+static void textarea_scroll_cb(lv_event_t *e);
 
 // 初始化显示管理器
 void mqtt_display_init(lv_obj_t *textarea_obj, lv_obj_t *msg_count_label, lv_obj_t *state_label) {
@@ -35,15 +65,27 @@ void mqtt_display_init(lv_obj_t *textarea_obj, lv_obj_t *msg_count_label, lv_obj
     // 清空缓冲区
     memset(message_buffer, 0, sizeof(message_buffer));
     message_count = 0;
+    view_len = 0;
+
+    if (!msg_store_init() || !msg_format_init()) {
+        ESP_LOGE(TAG, "消息存储初始化失败");
+    }
+    journal_init();
     
-    // 设置textarea样式
-    lv_obj_add_state(g_textarea, LV_STATE_DISABLED);  // 设为只读
+    // 设置textarea样式：只读但可点击（禁用状态下无法接收点击和滚动）
+    lv_obj_clear_flag(g_textarea, LV_OBJ_FLAG_CLICK_FOCUSABLE);
     lv_textarea_set_cursor_click_pos(g_textarea, false);
-    
-    // 设置外观
-    lv_obj_set_style_text_font(g_textarea, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_bg_color(g_textarea, lv_color_hex(0x000000), 0);
-    lv_obj_set_style_text_color(g_textarea, lv_color_hex(0x00FF00), 0);
+    lv_obj_set_style_opa(g_textarea, LV_OPA_TRANSP, LV_PART_CURSOR);
+    lv_obj_add_event_cb(g_textarea, textarea_click_cb, LV_EVENT_SHORT_CLICKED, NULL);
+    lv_obj_add_event_cb(g_textarea, textarea_scroll_cb, LV_EVENT_SCROLL_END, NULL);
+    
+    // 设置外观（背景和文字颜色使用界面层的共用样式）
+    // 日志区是重绘最频繁的区域，ASCII字符使用预光栅化的字形缓存
+    const lv_font_t *log_font = &lv_font_montserrat_12;
+#if GLYPH_CACHE_ENABLE
+    log_font = glyph_cache_create(log_font);
+#endif
+    lv_obj_set_style_text_font(g_textarea, log_font, 0);
     
     // 初始化显示
     lv_textarea_set_text(g_textarea, "");
@@ -59,94 +101,347 @@ void mqtt_display_init(lv_obj_t *textarea_obj, lv_obj_t *msg_count_label, lv_obj
         lv_obj_set_style_text_color(g_state_label, lv_color_hex(0xFF0000), 0);
     }
     
+    if (render_timer == NULL) {
+        render_timer = lv_timer_create(render_timer_cb, DISPLAY_RENDER_PERIOD_MS, NULL);
+    }
+
     ESP_LOGI(TAG, "MQTT消息显示管理器初始化成功");
 }
 
-// 清理旧消息（保留最新的消息）
-static void trim_old_messages(void) {
-    char *lines[100];
-    int line_count = 0;
-    char *line_start = message_buffer;
-    char *line_end;
-    
-    // 分割行
-    while ((line_end = strchr(line_start, '\n')) != NULL && line_count < 100) {
-        lines[line_count++] = line_start;
-        line_start = line_end + 1;
-    }
-    
-    // 如果超过40行，保留最新的40行
-    if (line_count > 40) {
-        int keep_lines = 40;
-        int start_line = line_count - keep_lines;
-        
-        char new_buffer[8192] = {0};
-        
-        for (int i = start_line; i < line_count; i++) {
-            char *next_line = (i < line_count - 1) ? lines[i + 1] - 1 : line_start;
-            size_t line_len = next_line - lines[i];
-            
-            if (line_len > 0 && line_len < 400) {
-                strncat(new_buffer, lines[i], line_len);
-                strcat(new_buffer, "\n");
-            }
+// 追加一行到显示缓冲区，空间不足时丢弃最旧的行
+// cur_len为缓冲区当前长度，返回追加后的长度（避免每行都对整个缓冲区strlen）
+static size_t buffer_append_line(size_t cur_len, const char *line) {
+    size_t line_len = strlen(line);
+
+    while (cur_len > 0 && cur_len + line_len >= sizeof(message_buffer)) {
+        char *first_end = strchr(message_buffer, '\n');
+        if (first_end == NULL) {
+            cur_len = 0;
+            message_buffer[0] = '\0';
+            break;
         }
-        
-        strcpy(message_buffer, new_buffer);
-        ESP_LOGI(TAG, "清理旧消息，保留%d行", keep_lines);
+        size_t drop = first_end - message_buffer + 1;
+        memmove(message_buffer, message_buffer + drop, cur_len - drop + 1);
+        cur_len -= drop;
+    }
+    if (line_len < sizeof(message_buffer)) {
+        memcpy(message_buffer + cur_len, line, line_len + 1);
+        cur_len += line_len;
     }
+    return cur_len;
 }
 
-// 添加MQTT消息
-void mqtt_display_add_message(const char *topic, const char *message, int qos, bool retained) {
-    if (!g_textarea || !topic || !message) {
-        ESP_LOGE(TAG, "参数无效");
+// 根据视图重建文本框内容（只格式化视图中的行，格式化结果来自LRU缓存）
+// keep_bottom为true时保持与底部的距离不变（回看区在上方插入了新行）
+static void render_view(bool keep_bottom) {
+    lv_coord_t dist_bottom = lv_obj_get_scroll_bottom(g_textarea);
+    size_t len = history_len;
+
+    memcpy(message_buffer, history_text, history_len + 1);
+    for (size_t i = 0; i < view_len; i++) {
+        const char *line = msg_format_line(view_seqs[i]);
+        len = buffer_append_line(len, line != NULL ? line : "");
+        len = buffer_append_line(len, "\n");
+    }
+    lv_textarea_set_text(g_textarea, message_buffer);
+    view_dirty = false;
+
+    if (auto_scroll_enabled) {
+        // 跟随最新消息时直接跳到底部：滚动动画的每一帧都要重绘并重新传输整个文本框，
+        // 消息密集时动画首尾相接，SPI带宽几乎全部消耗在滚动上
+        lv_obj_scroll_to_y(g_textarea, LV_COORD_MAX, LV_ANIM_OFF);
+    } else if (keep_bottom) {
+        lv_obj_update_layout(g_textarea);
+        lv_coord_t grow = lv_obj_get_scroll_bottom(g_textarea) - dist_bottom;
+        lv_obj_scroll_to_y(g_textarea, lv_obj_get_scroll_y(g_textarea) + grow, LV_ANIM_OFF);
+    }
+}
+
+static void history_reset(void) {
+    history_text[0] = '\0';
+    history_len = 0;
+    history_lines = 0;
+    history_exhausted = false;
+    history_stale = history_pending;
+}
+
+// 丢弃回看区最上面的一行
+static void history_drop_first(void) {
+    char *first_end = strchr(history_text, '\n');
+    size_t drop = first_end != NULL ? (size_t)(first_end - history_text) + 1 : history_len;
+
+    memmove(history_text, history_text + drop, history_len - drop + 1);
+    history_len -= drop;
+    memmove(history_seqs, history_seqs + 1, (history_lines - 1) * sizeof(history_seqs[0]));
+    history_lines--;
+    history_exhausted = false;      // 顶部已被丢弃，可以重新向前读取
+}
+
+// 视图滚出的最旧一行移入回看区底部，保持回看区与视图连续
+static void history_push_back(uint32_t seq) {
+    const char *line = msg_format_line(seq);
+    if (line == NULL) {
+        line = "";
+    }
+    size_t line_len = strlen(line);
+
+    if (line_len + 2 > sizeof(history_text)) {
         return;
     }
-    
-    char time_str[16];
-    char formatted_msg[400];
-    
-    get_time_string(time_str, sizeof(time_str));
-    message_count++;
-    
-    // 格式化消息
-    snprintf(formatted_msg, sizeof(formatted_msg),
-             "[%lu] %s [Q%d%s] %s: %s\n",
-             (unsigned long)message_count,
-             time_str,
-             qos,
-             retained ? "R" : "",
-             topic,
-             message);
-    
-    // 检查缓冲区空间
-    size_t current_len = strlen(message_buffer);
-    size_t new_msg_len = strlen(formatted_msg);
-    
-    if (current_len + new_msg_len >= sizeof(message_buffer) - 100) {
-        trim_old_messages();
+    while (history_lines > 0 &&
+           (history_lines == DISPLAY_HISTORY_LINES || history_len + line_len + 2 > sizeof(history_text))) {
+        history_drop_first();
     }
-    
-    // 添加消息
-    strcat(message_buffer, formatted_msg);
-    
-    // 更新显示
-    lv_textarea_set_text(g_textarea, message_buffer);
-    
-    // 更新消息计数
-    if (g_msg_count_label) {
+    memcpy(history_text + history_len, line, line_len);
+    history_len += line_len;
+    history_text[history_len++] = '\n';
+    history_text[history_len] = '\0';
+    history_seqs[history_lines++] = seq + journal_offset;
+}
+
+// 把一批日志记录（从旧到新）插入回看区顶部，放不下的较旧记录被舍弃
+static void history_prepend(const journal_record_t *recs, size_t n) {
+    static char block[DISPLAY_HISTORY_BATCH * MSG_FMT_LINE_LEN];
+    size_t offs[DISPLAY_HISTORY_BATCH + 1];
+    msg_record_t rec = {0};
+    size_t len = 0;
+
+    if (n > DISPLAY_HISTORY_BATCH) {
+        recs += n - DISPLAY_HISTORY_BATCH;
+        n = DISPLAY_HISTORY_BATCH;
+    }
+    for (size_t i = 0; i < n; i++) {
+        rec.seq = recs[i].seq;
+        rec.qos = recs[i].qos;
+        rec.flags = recs[i].flags;
+        rec.payload_len = recs[i].payload_len;
+        offs[i] = len;
+        msg_format_record_line(&rec, recs[i].time_ms, recs[i].topic, recs[i].payload, recs[i].payload_len,
+                               block + len, sizeof(block) - len - 1);
+        len += strlen(block + len);
+        block[len++] = '\n';
+    }
+    offs[n] = len;
+
+    // 从最旧的一条开始舍弃，直到放得下
+    size_t skip = 0;
+    while (skip < n && (history_lines + n - skip > DISPLAY_HISTORY_LINES ||
+                        history_len + len - offs[skip] + 1 > sizeof(history_text))) {
+        skip++;
+    }
+    if (skip > 0) {
+        history_exhausted = true;   // 回看区已满
+    }
+    size_t add = len - offs[skip];
+    memmove(history_text + add, history_text, history_len + 1);
+    memcpy(history_text, block + offs[skip], add);
+    history_len += add;
+    memmove(history_seqs + (n - skip), history_seqs, history_lines * sizeof(history_seqs[0]));
+    for (size_t i = skip; i < n; i++) {
+        history_seqs[i - skip] = recs[i].seq;
+    }
+    history_lines += n - skip;
+}
+
+// 滚动到顶部时向闪存日志请求更早的记录
+static void history_request(void) {
+    msg_filter_t filter;
+    uint32_t before;
+
+    if (history_pending || history_exhausted) {
+        return;
+    }
+    if (history_lines > 0) {
+        before = history_seqs[0];
+    } else if (view_len > 0) {
+        before = view_seqs[0] + journal_offset;
+    } else {
+        journal_stats_t stats;
+        journal_get_stats(&stats);
+        before = stats.next_seq;
+    }
+    msg_store_get_filter(&filter);
+    if (journal_request_before(before, DISPLAY_HISTORY_BATCH, &filter)) {
+        history_pending = true;
+        history_stale = false;
+        render_wake();
+    }
+}
+
+// 滚动结束：在底部时恢复自动滚动并释放回看区，离开底部时暂停自动滚动，到达顶部时加载历史
+static void textarea_scroll_cb(lv_event_t *e) {
+    if (lv_obj_get_scroll_bottom(g_textarea) <= DISPLAY_SCROLL_EDGE_PX) {
+        auto_scroll_enabled = true;
+        if (history_lines > 0) {
+            history_reset();
+            view_dirty = true;
+            render_wake();
+        }
+        return;
+    }
+    auto_scroll_enabled = false;
+    if (lv_obj_get_scroll_top(g_textarea) <= DISPLAY_SCROLL_EDGE_PX) {
+        history_request();
+    }
+}
+
+// 有待刷新的内容时恢复刷新定时器
+static void render_wake(void) {
+    if (render_timer != NULL) {
+        lv_timer_resume(render_timer);
+    }
+}
+
+// 周期刷新：合并两次刷新之间到达的所有消息
+static void render_timer_cb(lv_timer_t *timer) {
+    if (history_pending) {
+        size_t n;
+        bool exhausted;
+        const journal_record_t *recs = journal_take_result(&n, &exhausted);
+        if (recs != NULL) {
+            history_pending = false;
+            if (!history_stale && g_textarea) {
+                history_exhausted = exhausted;
+                history_prepend(recs, n);
+                render_view(true);
+            }
+        }
+    }
+    if (view_dirty && g_textarea) {
+        render_view(false);
+    }
+    if (count_dirty && g_msg_count_label) {
         char count_str[16];
         snprintf(count_str, sizeof(count_str), "%lu", (unsigned long)message_count);
         lv_label_set_text(g_msg_count_label, count_str);
+        count_dirty = false;
     }
-    
-    // 自动滚动
-    if (auto_scroll_enabled) {
-        mqtt_display_scroll_to_bottom();
+    // 没有待处理的内容时暂停，LVGL任务可以一直睡眠到下一条消息或触摸
+    if (!history_pending && !view_dirty && !count_dirty) {
+        lv_timer_pause(timer);
     }
-    
-    ESP_LOGI(TAG, "添加消息: %s", topic);
+}
+
+// 新记录满足过滤条件时加入视图，等待下一次刷新
+static void view_push(uint32_t seq) {
+    if (!msg_store_match(seq)) {
+        return;
+    }
+    if (view_len == DISPLAY_MAX_LINES) {
+        if (history_lines > 0) {
+            history_push_back(view_seqs[0]);
+        }
+        memmove(view_seqs, view_seqs + 1, (DISPLAY_MAX_LINES - 1) * sizeof(view_seqs[0]));
+        view_len--;
+    }
+    view_seqs[view_len++] = seq;
+    view_dirty = true;
+    render_wake();
+}
+
+// 点击日志：定位被点击的行并弹窗显示格式化后的完整载荷
+static void textarea_click_cb(lv_event_t *e) {
+    lv_indev_t *indev = lv_indev_get_act();
+    lv_obj_t *label = lv_textarea_get_label(g_textarea);
+    lv_point_t point;
+
+    if (indev == NULL || view_dirty || history_pending || view_len == 0) {
+        return;
+    }
+    lv_indev_get_point(indev, &point);
+    point.x -= label->coords.x1;
+    point.y -= label->coords.y1;
+
+    const char *text = lv_label_get_text(label);
+    uint32_t letter = lv_label_get_letter_on(label, &point);
+    uint32_t byte_pos = _lv_txt_encoded_get_byte_id(text, letter);
+    size_t line = 0;
+    for (uint32_t i = 0; i < byte_pos && text[i] != '\0'; i++) {
+        if (text[i] == '\n') {
+            line++;
+        }
+    }
+    if (line < history_lines || line - history_lines >= view_len) {
+        return;     // 回看区的行只在闪存中，不展开
+    }
+
+    char topic[MSG_STORE_TOPIC_LEN];
+    const char *detail = msg_format_detail(view_seqs[line - history_lines], topic);
+    if (detail == NULL) {
+        return;
+    }
+    lv_obj_t *mbox = lv_msgbox_create(NULL, topic, detail, NULL, true);
+    lv_obj_set_width(mbox, 300);
+    lv_obj_set_style_text_font(mbox, &lv_font_montserrat_12, 0);
+    lv_obj_set_style_max_height(lv_msgbox_get_content(mbox), 160, 0);
+    lv_obj_center(mbox);
+}
+
+// 按当前过滤条件重新查询视图
+static void view_rebuild(void) {
+    uint32_t newest_first[DISPLAY_MAX_LINES];
+    size_t n = msg_store_query(newest_first, DISPLAY_MAX_LINES);
+
+    for (size_t i = 0; i < n; i++) {
+        view_seqs[i] = newest_first[n - 1 - i];
+    }
+    view_len = n;
+    history_reset();
+    render_view(false);
+}
+
+// 写入闪存日志，并记录日志序号与存储序号的对应关系
+static void journal_record(uint32_t seq, const char *topic, const void *payload, size_t payload_len,
+                           int qos, uint8_t flags, int64_t rx_time_us) {
+    uint32_t jseq = journal_append(topic, payload, payload_len, qos, flags,
+                                   msg_format_wall_ms(rx_time_us));
+    if (jseq != MSG_STORE_SEQ_NONE) {
+        journal_offset = (int32_t)(jseq - seq);
+        msg_format_set_seq_offset(journal_offset);
+    }
+}
+
+// 添加MQTT消息（原始载荷，只入库不格式化）
+void mqtt_display_add_raw(const char *topic, const void *payload, size_t payload_len,
+                          int qos, bool retained, int64_t rx_time_us) {
+    if (!g_textarea || !topic || (!payload && payload_len > 0)) {
+        ESP_LOGE(TAG, "参数无效");
+        return;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (rx_time_us == 0 || rx_time_us > now_us) {
+        rx_time_us = now_us;
+    }
+    uint32_t latency_us = (uint32_t)(now_us - rx_time_us);
+    latency_avg_us = latency_avg_us - latency_avg_us / 16 + latency_us / 16;
+    if (latency_us > latency_max_us) {
+        latency_max_us = latency_us;
+    }
+
+    uint32_t seq = msg_store_append(topic, payload, payload_len, qos,
+                                    retained ? MSG_FLAG_RETAINED : 0, rx_time_us);
+    if (seq == MSG_STORE_SEQ_NONE) {
+        ESP_LOGE(TAG, "消息存储失败: %s", topic);
+        return;
+    }
+    message_count++;
+    count_dirty = true;
+    render_wake();
+    journal_record(seq, topic, payload, payload_len, qos, retained ? MSG_FLAG_RETAINED : 0, rx_time_us);
+
+    series_feed(topic, payload, payload_len, rx_time_us);
+    view_push(seq);
+    ESP_LOGD(TAG, "添加消息: %s (%u字节)", topic, (unsigned)payload_len);
+}
+
+// 添加MQTT消息
+void mqtt_display_add_message(const char *topic, const char *message, int qos, bool retained) {
+    if (!message) {
+        ESP_LOGE(TAG, "参数无效");
+        return;
+    }
+    mqtt_display_add_raw(topic, message, strlen(message), qos, retained, 0);
 }
 
 // 添加系统消息
@@ -155,40 +450,69 @@ void mqtt_display_add_system_msg(const char *message, const char *level) {
         ESP_LOGE(TAG, "参数无效");
         return;
     }
-    
-    char time_str[16];
-    char formatted_msg[256];
-    
-    get_time_string(time_str, sizeof(time_str));
-    
-    snprintf(formatted_msg, sizeof(formatted_msg),
-             "[SYS] %s [%s] %s\n",
-             time_str,
-             level,
-             message);
-    
-    // 检查缓冲区空间
-    size_t current_len = strlen(message_buffer);
-    size_t new_msg_len = strlen(formatted_msg);
-    
-    if (current_len + new_msg_len >= sizeof(message_buffer) - 100) {
-        trim_old_messages();
-    }
-    
-    // 添加系统消息
-    strcat(message_buffer, formatted_msg);
-    
-    // 更新显示
-    lv_textarea_set_text(g_textarea, message_buffer);
-    
-    // 自动滚动
-    if (auto_scroll_enabled) {
-        mqtt_display_scroll_to_bottom();
+
+    int64_t now_us = esp_timer_get_time();
+    uint32_t seq = msg_store_append(level, message, strlen(message), 0, MSG_FLAG_SYSTEM, now_us);
+    if (seq != MSG_STORE_SEQ_NONE) {
+        journal_record(seq, level, message, strlen(message), 0, MSG_FLAG_SYSTEM, now_us);
+        view_push(seq);
     }
-    
+
     ESP_LOGI(TAG, "添加系统消息: [%s] %s", level, message);
 }
 
+// 设置过滤条件
+void mqtt_display_set_filter(const char *topic_pattern, const char *payload_substr) {
+    msg_filter_t filter = {0};
+
+    if (topic_pattern) {
+        strncpy(filter.topic_pattern, topic_pattern, sizeof(filter.topic_pattern) - 1);
+    }
+    if (payload_substr) {
+        strncpy(filter.payload_substr, payload_substr, sizeof(filter.payload_substr) - 1);
+    }
+    msg_store_set_filter(&filter);
+
+    if (g_textarea) {
+        lv_textarea_set_placeholder_text(g_textarea, msg_store_filter_active() ? "无匹配消息" : "等待MQTT消息...");
+        view_rebuild();
+    }
+    ESP_LOGI(TAG, "过滤条件: topic=\"%s\" payload=\"%s\"", filter.topic_pattern, filter.payload_substr);
+}
+
+// 解析过滤栏输入
+void mqtt_display_set_filter_expr(const char *expr) {
+    char topic[MSG_STORE_PATTERN_LEN] = {0};
+    char payload[MSG_STORE_PATTERN_LEN] = {0};
+
+    if (expr == NULL) {
+        mqtt_display_set_filter(NULL, NULL);
+        return;
+    }
+    while (*expr == ' ') {
+        expr++;
+    }
+
+    const char *space = strchr(expr, ' ');
+    if (space != NULL) {
+        // "主题模式 载荷子串"
+        size_t n = space - expr;
+        if (n >= sizeof(topic)) {
+            n = sizeof(topic) - 1;
+        }
+        memcpy(topic, expr, n);
+        while (*space == ' ') {
+            space++;
+        }
+        strncpy(payload, space, sizeof(payload) - 1);
+    } else if (strpbrk(expr, "/+#") != NULL) {
+        strncpy(topic, expr, sizeof(topic) - 1);
+    } else {
+        strncpy(payload, expr, sizeof(payload) - 1);
+    }
+    mqtt_display_set_filter(topic, payload);
+}
+
 // 清空消息
 void mqtt_display_clear(void) {
     if (!g_textarea) {
@@ -198,6 +522,13 @@ void mqtt_display_clear(void) {
     
     memset(message_buffer, 0, sizeof(message_buffer));
     message_count = 0;
+    view_len = 0;
+    view_dirty = false;
+    count_dirty = false;
+    auto_scroll_enabled = true;
+    history_reset();
+    msg_store_clear();
+    msg_format_invalidate();
     
     lv_textarea_set_text(g_textarea, "");
     
@@ -231,6 +562,16 @@ uint32_t mqtt_display_get_msg_count(void) {
     return message_count;
 }
 
+// 获取排队延迟
+void mqtt_display_get_latency(uint32_t *avg_us, uint32_t *max_us) {
+    if (avg_us) {
+        *avg_us = latency_avg_us;
+    }
+    if (max_us) {
+        *max_us = latency_max_us;
+    }
+}
+
 // 滚动到底部
 void mqtt_display_scroll_to_bottom(void) {
     if (g_textarea) {
@@ -0,0 +1,611 @@
+#include "mqtt_message_journal.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_rom_crc.h"
+#include "esp_spiffs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "MSG_JOURNAL";
+
+#define JOURNAL_MAGIC           0x4A52          ///< 记录头魔数 "JR"
+#define JOURNAL_FOOTER_MAGIC    0x5844494Au     ///< 分段尾魔数 "JIDX"
+#define JOURNAL_PAYLOAD_MAX     (sizeof(((journal_record_t *)0)->payload))
+#define JOURNAL_PATH_LEN        32
+
+/**
+ * @brief 记录头（其后紧跟主题和载荷）
+ */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;         ///< JOURNAL_MAGIC
+    uint16_t topic_len;     ///< 主题长度
+    uint16_t payload_len;   ///< 载荷长度
+    uint8_t qos;            ///< 服务质量等级
+    uint8_t flags;          ///< MSG_FLAG_*
+    uint32_t seq;           ///< 日志序号
+    int64_t time_ms;        ///< 接收时间（Unix毫秒）
+    uint32_t crc;           ///< 头（crc字段为0）+主题+载荷的CRC32
+} journal_hdr_t;
+
+/**
+ * @brief 稀疏索引项
+ */
+typedef struct {
+    uint32_t seq;   ///< 块内第一条记录的序号
+    uint32_t off;   ///< 该记录在分段内的偏移
+} journal_index_t;
+
+/**
+ * @brief 分段尾（位于文件最后，索引项在其之前）
+ */
+typedef struct {
+    uint32_t magic;     ///< JOURNAL_FOOTER_MAGIC
+    uint32_t count;     ///< 索引项数
+    uint32_t data_end;  ///< 记录区结束偏移
+    uint32_t last_seq;  ///< 最后一条记录的序号
+} journal_trailer_t;
+
+#define JOURNAL_INDEX_MAX       (JOURNAL_SEGMENT_SIZE / sizeof(journal_hdr_t) / JOURNAL_INDEX_INTERVAL + 2)
+#define JOURNAL_FOOTER_RESERVE  (JOURNAL_INDEX_MAX * sizeof(journal_index_t) + sizeof(journal_trailer_t))
+
+/**
+ * @brief 分段目录项
+ */
+typedef struct {
+    uint32_t id;        ///< 分段文件编号
+    uint32_t first_seq; ///< 第一条记录序号，MSG_STORE_SEQ_NONE表示空分段
+    uint32_t last_seq;  ///< 最后一条记录序号
+} journal_seg_t;
+
+typedef enum {
+    REQ_IDLE = 0,
+    REQ_PENDING,
+    REQ_DONE,
+} journal_req_state_t;
+
+static bool s_ready = false;
+static RingbufHandle_t s_ringbuf = NULL;
+static SemaphoreHandle_t s_lock = NULL;     ///< 保护分段目录和统计信息
+static uint32_t s_next_seq = 1;
+static uint32_t s_pages = 0;
+static uint32_t s_dropped = 0;
+
+// 分段目录（按编号升序）
+static journal_seg_t s_segs[JOURNAL_MAX_SEGMENTS + 1];
+static size_t s_seg_count = 0;
+
+// 当前写入分段（仅写任务访问）
+static FILE *s_active = NULL;
+static uint32_t s_active_bytes = 0;         ///< 已写入+页缓冲中的字节数
+static uint32_t s_active_records = 0;
+static journal_index_t s_active_index[JOURNAL_INDEX_MAX];
+static size_t s_active_index_n = 0;
+static uint8_t *s_page = NULL;
+static size_t s_page_len = 0;
+static TickType_t s_page_since = 0;         ///< 页缓冲变为非空的时刻
+
+// 回看请求
+static volatile journal_req_state_t s_req_state = REQ_IDLE;
+static uint32_t s_req_before = 0;
+static size_t s_req_max = 0;
+static msg_filter_t s_req_filter;
+static journal_record_t *s_results = NULL;
+static size_t s_result_n = 0;
+static bool s_result_exhausted = false;
+static journal_index_t *s_read_index = NULL;
+static uint8_t *s_scratch = NULL;           ///< 主题+载荷读取缓冲区
+
+static void seg_path(uint32_t id, char *path) {
+    snprintf(path, JOURNAL_PATH_LEN, JOURNAL_BASE_PATH "/s%07lu.log", (unsigned long)id);
+}
+
+static uint32_t record_crc(const journal_hdr_t *hdr, const uint8_t *body, size_t body_len) {
+    journal_hdr_t tmp = *hdr;
+    tmp.crc = 0;
+    uint32_t crc = esp_rom_crc32_le(0, (const uint8_t *)&tmp, sizeof(tmp));
+    return esp_rom_crc32_le(crc, body, body_len);
+}
+
+// 读取一条记录头和数据并校验，失败返回false
+static bool read_record(FILE *f, journal_hdr_t *hdr, uint8_t *body) {
+    if (fread(hdr, 1, sizeof(*hdr), f) != sizeof(*hdr) || hdr->magic != JOURNAL_MAGIC ||
+        hdr->topic_len >= MSG_STORE_TOPIC_LEN || hdr->payload_len > JOURNAL_PAYLOAD_MAX) {
+        return false;
+    }
+    size_t body_len = hdr->topic_len + hdr->payload_len;
+    if (fread(body, 1, body_len, f) != body_len) {
+        return false;
+    }
+    return record_crc(hdr, body, body_len) == hdr->crc;
+}
+
+// 读取分段尾，成功时索引写入index
+static bool read_footer(FILE *f, journal_trailer_t *trailer, journal_index_t *index) {
+    if (fseek(f, -(long)sizeof(*trailer), SEEK_END) != 0 ||
+        fread(trailer, 1, sizeof(*trailer), f) != sizeof(*trailer) ||
+        trailer->magic != JOURNAL_FOOTER_MAGIC || trailer->count > JOURNAL_INDEX_MAX) {
+        return false;
+    }
+    if (index != NULL) {
+        long off = -(long)(sizeof(*trailer) + trailer->count * sizeof(journal_index_t));
+        if (fseek(f, off, SEEK_END) != 0 ||
+            fread(index, sizeof(journal_index_t), trailer->count, f) != trailer->count) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void write_footer(FILE *f, const journal_index_t *index, size_t n,
+                         uint32_t data_end, uint32_t last_seq) {
+    journal_trailer_t trailer = {
+        .magic = JOURNAL_FOOTER_MAGIC,
+        .count = n,
+        .data_end = data_end,
+        .last_seq = last_seq,
+    };
+    fwrite(index, sizeof(journal_index_t), n, f);
+    fwrite(&trailer, 1, sizeof(trailer), f);
+}
+
+// 扫描未正常关闭的分段，恢复索引并补写分段尾
+static bool recover_segment(journal_seg_t *seg) {
+    char path[JOURNAL_PATH_LEN];
+    journal_hdr_t hdr;
+    uint32_t pos = 0, records = 0;
+    size_t n = 0;
+
+    seg_path(seg->id, path);
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    seg->first_seq = MSG_STORE_SEQ_NONE;
+    while (read_record(f, &hdr, s_scratch)) {
+        if (records % JOURNAL_INDEX_INTERVAL == 0 && n < JOURNAL_INDEX_MAX) {
+            s_read_index[n++] = (journal_index_t){.seq = hdr.seq, .off = pos};
+        }
+        if (seg->first_seq == MSG_STORE_SEQ_NONE) {
+            seg->first_seq = hdr.seq;
+        }
+        seg->last_seq = hdr.seq;
+        pos += sizeof(hdr) + hdr.topic_len + hdr.payload_len;
+        records++;
+    }
+    fclose(f);
+
+    if (records == 0) {
+        unlink(path);
+        return false;
+    }
+    // 尾部可能有写了一半的记录，分段尾中的data_end会把它排除在外
+    f = fopen(path, "ab");
+    if (f == NULL) {
+        return false;
+    }
+    write_footer(f, s_read_index, n, pos, seg->last_seq);
+    fclose(f);
+    ESP_LOGW(TAG, "恢复分段 %lu: %lu条记录", (unsigned long)seg->id, (unsigned long)records);
+    return true;
+}
+
+// 读取已关闭分段的首尾序号，必要时恢复
+static bool load_segment(journal_seg_t *seg) {
+    char path[JOURNAL_PATH_LEN];
+    journal_trailer_t trailer;
+    journal_hdr_t hdr;
+
+    seg_path(seg->id, path);
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+    bool closed = read_footer(f, &trailer, NULL);
+    bool has_first = fseek(f, 0, SEEK_SET) == 0 && read_record(f, &hdr, s_scratch);
+    fclose(f);
+
+    if (!closed) {
+        return recover_segment(seg);
+    }
+    if (!has_first || trailer.data_end == 0) {
+        unlink(path);
+        return false;
+    }
+    seg->first_seq = hdr.seq;
+    seg->last_seq = trailer.last_seq;
+    return true;
+}
+
+static void scan_directory(void) {
+    DIR *dir = opendir(JOURNAL_BASE_PATH);
+    struct dirent *ent;
+    unsigned long id;
+
+    s_seg_count = 0;
+    if (dir == NULL) {
+        return;
+    }
+    while ((ent = readdir(dir)) != NULL) {
+        if (sscanf(ent->d_name, "s%7lu.log", &id) != 1) {
+            continue;
+        }
+        if (s_seg_count == JOURNAL_MAX_SEGMENTS + 1) {
+            // 目录已满：丢弃编号最小的一项（稍后删除）
+            char path[JOURNAL_PATH_LEN];
+            uint32_t drop = id < s_segs[0].id ? (uint32_t)id : s_segs[0].id;
+            seg_path(drop, path);
+            unlink(path);
+            if (drop == id) {
+                continue;
+            }
+            memmove(s_segs, s_segs + 1, (s_seg_count - 1) * sizeof(s_segs[0]));
+            s_seg_count--;
+        }
+        // 按编号插入排序
+        size_t pos = s_seg_count;
+        while (pos > 0 && s_segs[pos - 1].id > id) {
+            s_segs[pos] = s_segs[pos - 1];
+            pos--;
+        }
+        s_segs[pos] = (journal_seg_t){.id = (uint32_t)id};
+        s_seg_count++;
+    }
+    closedir(dir);
+
+    size_t kept = 0;
+    for (size_t i = 0; i < s_seg_count; i++) {
+        if (load_segment(&s_segs[i])) {
+            s_segs[kept++] = s_segs[i];
+        }
+    }
+    s_seg_count = kept;
+}
+
+static void flush_page(void) {
+    if (s_page_len == 0 || s_active == NULL) {
+        return;
+    }
+    fwrite(s_page, 1, s_page_len, s_active);
+    fflush(s_active);
+    fsync(fileno(s_active));
+    s_page_len = 0;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_pages++;
+    xSemaphoreGive(s_lock);
+}
+
+static void close_segment(void) {
+    if (s_active == NULL) {
+        return;
+    }
+    flush_page();
+    write_footer(s_active, s_active_index, s_active_index_n, s_active_bytes,
+                 s_seg_count > 0 ? s_segs[s_seg_count - 1].last_seq : MSG_STORE_SEQ_NONE);
+    fclose(s_active);
+    s_active = NULL;
+}
+
+static bool open_segment(void) {
+    char path[JOURNAL_PATH_LEN];
+    uint32_t id = s_seg_count > 0 ? s_segs[s_seg_count - 1].id + 1 : 1;
+
+    seg_path(id, path);
+    s_active = fopen(path, "wb");
+    if (s_active == NULL) {
+        ESP_LOGE(TAG, "无法创建分段 %s", path);
+        return false;
+    }
+    setvbuf(s_active, NULL, _IONBF, 0);     // 页缓冲由本模块管理
+    s_active_bytes = 0;
+    s_active_records = 0;
+    s_active_index_n = 0;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_segs[s_seg_count++] = (journal_seg_t){.id = id};
+    if (s_seg_count > JOURNAL_MAX_SEGMENTS) {
+        // 整段删除最旧的分段，不做任何原地改写
+        seg_path(s_segs[0].id, path);
+        unlink(path);
+        memmove(s_segs, s_segs + 1, (s_seg_count - 1) * sizeof(s_segs[0]));
+        s_seg_count--;
+    }
+    xSemaphoreGive(s_lock);
+    return true;
+}
+
+// 写任务：把一条记录放入页缓冲，写满一页才落盘
+static void add_record(uint8_t *item, size_t size) {
+    journal_hdr_t *hdr = (journal_hdr_t *)item;
+
+    if (s_active != NULL && s_active_bytes + size > JOURNAL_SEGMENT_SIZE - JOURNAL_FOOTER_RESERVE) {
+        close_segment();
+    }
+    if (s_active == NULL && !open_segment()) {
+        return;
+    }
+
+    hdr->crc = record_crc(hdr, item + sizeof(*hdr), size - sizeof(*hdr));
+    if (s_active_records % JOURNAL_INDEX_INTERVAL == 0 && s_active_index_n < JOURNAL_INDEX_MAX) {
+        s_active_index[s_active_index_n++] = (journal_index_t){.seq = hdr->seq, .off = s_active_bytes};
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    journal_seg_t *seg = &s_segs[s_seg_count - 1];
+    if (seg->first_seq == MSG_STORE_SEQ_NONE) {
+        seg->first_seq = hdr->seq;
+    }
+    seg->last_seq = hdr->seq;
+    xSemaphoreGive(s_lock);
+
+    if (s_page_len == 0) {
+        s_page_since = xTaskGetTickCount();
+    }
+    size_t done = 0;
+    while (done < size) {
+        size_t chunk = JOURNAL_PAGE_SIZE - s_page_len;
+        if (chunk > size - done) {
+            chunk = size - done;
+        }
+        memcpy(s_page + s_page_len, item + done, chunk);
+        s_page_len += chunk;
+        done += chunk;
+        if (s_page_len == JOURNAL_PAGE_SIZE) {
+            flush_page();
+            s_page_since = xTaskGetTickCount();
+        }
+    }
+    s_active_bytes += size;
+    s_active_records++;
+}
+
+// 读取fseek位置处的一条记录到结果项
+static bool read_result(FILE *f, uint32_t off, journal_record_t *out) {
+    journal_hdr_t hdr;
+
+    if (fseek(f, off, SEEK_SET) != 0 || !read_record(f, &hdr, s_scratch)) {
+        return false;
+    }
+    out->seq = hdr.seq;
+    out->time_ms = hdr.time_ms;
+    out->qos = hdr.qos;
+    out->flags = hdr.flags;
+    out->payload_len = hdr.payload_len;
+    memcpy(out->topic, s_scratch, hdr.topic_len);
+    out->topic[hdr.topic_len] = '\0';
+    memcpy(out->payload, s_scratch + hdr.topic_len, hdr.payload_len);
+    return true;
+}
+
+// 写任务：处理回看请求。从新到旧遍历分段和索引块，块内顺序读取
+static void serve_request(void) {
+    char path[JOURNAL_PATH_LEN];
+    uint32_t offs[JOURNAL_INDEX_INTERVAL];
+    size_t need = s_req_max;
+    size_t filled = 0;
+    uint32_t blocks = 0;
+    bool exhausted = true;
+
+    flush_page();
+    for (int si = (int)s_seg_count - 1; si >= 0 && exhausted; si--) {
+        journal_seg_t seg = s_segs[si];
+        if (seg.first_seq == MSG_STORE_SEQ_NONE || seg.first_seq >= s_req_before) {
+            continue;
+        }
+        seg_path(seg.id, path);
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            continue;
+        }
+
+        const journal_index_t *index;
+        size_t n;
+        uint32_t data_end;
+        journal_trailer_t trailer;
+        if (si == (int)s_seg_count - 1 && s_active != NULL) {
+            index = s_active_index;
+            n = s_active_index_n;
+            data_end = s_active_bytes;
+        } else if (read_footer(f, &trailer, s_read_index)) {
+            index = s_read_index;
+            n = trailer.count;
+            data_end = trailer.data_end;
+        } else {
+            fclose(f);
+            continue;
+        }
+
+        for (int b = (int)n - 1; b >= 0; b--) {
+            if (filled == need || blocks == JOURNAL_SCAN_BLOCKS) {
+                exhausted = false;
+                break;
+            }
+            if (index[b].seq >= s_req_before) {
+                continue;
+            }
+            blocks++;
+            uint32_t end = (b + 1 < (int)n) ? index[b + 1].off : data_end;
+            uint32_t pos = index[b].off;
+            size_t m = 0;
+            journal_hdr_t hdr;
+
+            // 第一遍：找出块内满足条件的记录偏移
+            fseek(f, pos, SEEK_SET);
+            while (pos < end && m < JOURNAL_INDEX_INTERVAL && read_record(f, &hdr, s_scratch)) {
+                if (hdr.seq < s_req_before &&
+                    msg_filter_matches(&s_req_filter, (const char *)s_scratch, hdr.topic_len,
+                                       s_scratch + hdr.topic_len, hdr.payload_len, hdr.flags)) {
+                    offs[m++] = pos;
+                }
+                pos += sizeof(hdr) + hdr.topic_len + hdr.payload_len;
+            }
+            // 第二遍：只读取需要的最新几条，从结果数组尾部向前填充
+            for (size_t k = 0; k < m && filled < need; k++) {
+                if (read_result(f, offs[m - 1 - k], &s_results[need - 1 - filled])) {
+                    filled++;
+                }
+            }
+        }
+        fclose(f);
+    }
+    // 填满时最后一个块（可能是最旧的块）里可能还有未返回的记录，不能判定为已到头；
+    // 确实没有更早的记录时下一次请求返回0条
+    if (filled == need) {
+        exhausted = false;
+    }
+
+    memmove(s_results, s_results + (need - filled), filled * sizeof(s_results[0]));
+    s_result_n = filled;
+    s_result_exhausted = exhausted;
+    s_req_state = REQ_DONE;
+    ESP_LOGD(TAG, "回看: %u条记录, 扫描%lu块", (unsigned)filled, (unsigned long)blocks);
+}
+
+static void journal_task(void *arg) {
+    while (1) {
+        size_t size;
+        uint8_t *item = xRingbufferReceive(s_ringbuf, &size, pdMS_TO_TICKS(100));
+        if (item != NULL) {
+            add_record(item, size);
+            vRingbufferReturnItem(s_ringbuf, item);
+        }
+        if (s_page_len > 0 && xTaskGetTickCount() - s_page_since >= pdMS_TO_TICKS(JOURNAL_FLUSH_MS)) {
+            flush_page();
+        }
+        if (s_req_state == REQ_PENDING) {
+            serve_request();
+        }
+    }
+}
+
+bool journal_init(void) {
+    if (s_ready) {
+        return true;
+    }
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = JOURNAL_BASE_PATH,
+        .partition_label = JOURNAL_PARTITION_LABEL,
+        .max_files = 4,
+        .format_if_mount_failed = true,
+    };
+    esp_err_t ret = esp_vfs_spiffs_register(&conf);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "日志分区挂载失败(%s)，消息历史不会持久化", esp_err_to_name(ret));
+        return false;
+    }
+
+    s_lock = xSemaphoreCreateMutex();
+    s_ringbuf = xRingbufferCreate(JOURNAL_RINGBUF_SIZE, RINGBUF_TYPE_NOSPLIT);
+    s_page = heap_caps_malloc(JOURNAL_PAGE_SIZE, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
+    s_results = heap_caps_calloc(JOURNAL_READ_MAX, sizeof(journal_record_t), MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (s_results == NULL) {
+        s_results = heap_caps_calloc(JOURNAL_READ_MAX, sizeof(journal_record_t), MALLOC_CAP_8BIT);
+    }
+    s_read_index = heap_caps_malloc(JOURNAL_INDEX_MAX * sizeof(journal_index_t), MALLOC_CAP_8BIT);
+    s_scratch = heap_caps_malloc(MSG_STORE_TOPIC_LEN + JOURNAL_PAYLOAD_MAX, MALLOC_CAP_8BIT);
+    if (s_lock == NULL || s_ringbuf == NULL || s_page == NULL || s_results == NULL ||
+        s_read_index == NULL || s_scratch == NULL) {
+        ESP_LOGE(TAG, "日志内存分配失败");
+        return false;
+    }
+
+    scan_directory();
+    if (s_seg_count > 0) {
+        s_next_seq = s_segs[s_seg_count - 1].last_seq + 1;
+    }
+
+    if (xTaskCreate(journal_task, "msg_journal", JOURNAL_TASK_STACK, NULL,
+                    JOURNAL_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "日志任务创建失败");
+        return false;
+    }
+    s_ready = true;
+
+    size_t total = 0, used = 0;
+    esp_spiffs_info(JOURNAL_PARTITION_LABEL, &total, &used);
+    ESP_LOGI(TAG, "日志就绪: %u个分段, 序号%lu~%lu, 已用%uKB/%uKB", (unsigned)s_seg_count,
+             (unsigned long)(s_seg_count ? s_segs[0].first_seq : 0), (unsigned long)(s_next_seq - 1),
+             (unsigned)(used / 1024), (unsigned)(total / 1024));
+    return true;
+}
+
+uint32_t journal_append(const char *topic, const void *payload, size_t payload_len,
+                        int qos, uint8_t flags, int64_t time_ms) {
+    void *item;
+
+    if (!s_ready || topic == NULL) {
+        return MSG_STORE_SEQ_NONE;
+    }
+    size_t topic_len = strnlen(topic, MSG_STORE_TOPIC_LEN - 1);
+    if (payload_len > JOURNAL_PAYLOAD_MAX) {
+        payload_len = JOURNAL_PAYLOAD_MAX;
+    }
+    uint32_t seq = s_next_seq++;
+
+    size_t size = sizeof(journal_hdr_t) + topic_len + payload_len;
+    if (xRingbufferSendAcquire(s_ringbuf, &item, size, 0) != pdTRUE) {
+        s_dropped++;
+        return seq;
+    }
+    journal_hdr_t *hdr = item;
+    *hdr = (journal_hdr_t){
+        .magic = JOURNAL_MAGIC,
+        .topic_len = topic_len,
+        .payload_len = payload_len,
+        .qos = (uint8_t)qos,
+        .flags = flags,
+        .seq = seq,
+        .time_ms = time_ms,
+    };
+    memcpy((uint8_t *)item + sizeof(*hdr), topic, topic_len);
+    if (payload_len > 0) {
+        memcpy((uint8_t *)item + sizeof(*hdr) + topic_len, payload, payload_len);
+    }
+    xRingbufferSendComplete(s_ringbuf, item);
+    return seq;
+}
+
+bool journal_request_before(uint32_t before_seq, size_t max, const msg_filter_t *filter) {
+    if (!s_ready || s_req_state != REQ_IDLE || max == 0) {
+        return false;
+    }
+    s_req_before = before_seq;
+    s_req_max = max < JOURNAL_READ_MAX ? max : JOURNAL_READ_MAX;
+    if (filter != NULL) {
+        s_req_filter = *filter;
+    } else {
+        memset(&s_req_filter, 0, sizeof(s_req_filter));
+    }
+    s_req_state = REQ_PENDING;
+    return true;
+}
+
+const journal_record_t *journal_take_result(size_t *count, bool *exhausted) {
+    if (s_req_state != REQ_DONE) {
+        return NULL;
+    }
+    *count = s_result_n;
+    *exhausted = s_result_exhausted;
+    s_req_state = REQ_IDLE;
+    return s_results;
+}
+
+void journal_get_stats(journal_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!s_ready) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    stats->segments = s_seg_count;
+    stats->first_seq = s_seg_count > 0 ? s_segs[0].first_seq : MSG_STORE_SEQ_NONE;
+    stats->pages = s_pages;
+    xSemaphoreGive(s_lock);
+    stats->next_seq = s_next_seq;
+    stats->dropped = s_dropped;
+}
@@ -0,0 +1,525 @@
+#include "mqtt_message_store.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+static const char *TAG = "MSG_STORE";
+
+#define TOPIC_ID_OVERFLOW   (MSG_STORE_MAX_TOPICS - 1)  ///< 主题表满时共用的溢出桶
+#define TOPIC_ID_SYSTEM     0xFF                        ///< 系统消息不进入主题表
+#define TOPIC_HASH_SLOTS    (MSG_STORE_MAX_TOPICS * 2)  ///< 主题哈希表槽数（开放寻址）
+#define SEQ_INDEX(seq)      ((seq) & (MSG_STORE_CAPACITY - 1))
+#define MAX_BLOB_LEN        (MSG_STORE_ARENA_SIZE / 8)  ///< 单条记录数据上限
+
+/**
+ * @brief 主题表项
+ */
+typedef struct {
+    char name[MSG_STORE_TOPIC_LEN];  ///< 主题字符串
+    uint32_t last_seq;               ///< 倒排链头（该主题最新记录序号）
+    bool used;                       ///< 是否已分配
+} topic_entry_t;
+
+// 记录与数据区
+static msg_record_t *s_records = NULL;
+static uint8_t *s_arena = NULL;
+static uint32_t s_oldest_seq = 1;   ///< 最旧的有效记录序号
+static uint32_t s_next_seq = 1;     ///< 下一条记录序号
+static uint32_t s_arena_head = 0;   ///< 数据区写入位置
+
+// 主题索引
+static topic_entry_t s_topics[MSG_STORE_MAX_TOPICS];
+static uint8_t s_topic_hash[TOPIC_HASH_SLOTS];  ///< 0为空槽，否则为主题ID+1
+
+// 过滤条件
+static msg_filter_t s_filter;
+static bool s_filter_active = false;
+static uint64_t s_filter_topics = 0;  ///< 匹配主题位图
+
+static SemaphoreHandle_t s_mutex = NULL;
+
+// FNV-1a哈希
+static uint32_t topic_hash(const char *topic, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)topic[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static inline uint32_t record_count(void) {
+    return s_next_seq - s_oldest_seq;
+}
+
+static inline msg_record_t *record_at(uint32_t seq) {
+    return &s_records[SEQ_INDEX(seq)];
+}
+
+static inline bool seq_alive(uint32_t seq) {
+    return seq != MSG_STORE_SEQ_NONE && seq >= s_oldest_seq && seq < s_next_seq;
+}
+
+// 在内存块中查找子串
+static bool mem_contains(const uint8_t *hay, size_t hay_len, const char *needle) {
+    size_t n = strlen(needle);
+    if (n == 0) {
+        return true;
+    }
+    if (n > hay_len) {
+        return false;
+    }
+    const uint8_t first = (uint8_t)needle[0];
+    for (size_t i = 0; i + n <= hay_len; i++) {
+        if (hay[i] == first && memcmp(hay + i, needle, n) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool msg_topic_matches(const char *pattern, const char *topic, size_t topic_len) {
+    const char *p = pattern;
+    size_t i = 0;
+
+    while (*p != '\0') {
+        if (*p == '#') {
+            return true;  // '#'匹配剩余所有层级
+        }
+        if (*p == '+') {
+            while (i < topic_len && topic[i] != '/') {
+                i++;
+            }
+            p++;
+            continue;
+        }
+        if (i == topic_len) {
+            // "a/#" 同样匹配父级 "a"
+            return p[0] == '/' && p[1] == '#' && p[2] == '\0';
+        }
+        if (*p != topic[i]) {
+            return false;
+        }
+        p++;
+        i++;
+    }
+    return i == topic_len;
+}
+
+// 计算单个主题是否命中当前主题模式，并更新位图
+static void filter_update_topic_bit(uint8_t id) {
+    uint64_t bit = 1ULL << id;
+    s_filter_topics &= ~bit;
+    if (!s_filter_active || s_filter.topic_pattern[0] == '\0') {
+        return;
+    }
+    // 溢出桶中的记录逐条比较主题字符串，位图中始终保留
+    if (id == TOPIC_ID_OVERFLOW ||
+        (s_topics[id].used &&
+         msg_topic_matches(s_filter.topic_pattern, s_topics[id].name, strlen(s_topics[id].name)))) {
+        s_filter_topics |= bit;
+    }
+}
+
+static void topic_hash_insert(uint8_t id) {
+    uint32_t slot = topic_hash(s_topics[id].name, strlen(s_topics[id].name)) % TOPIC_HASH_SLOTS;
+    while (s_topic_hash[slot] != 0) {
+        slot = (slot + 1) % TOPIC_HASH_SLOTS;
+    }
+    s_topic_hash[slot] = id + 1;
+}
+
+static void topic_hash_rebuild(void) {
+    memset(s_topic_hash, 0, sizeof(s_topic_hash));
+    for (uint8_t id = 0; id < TOPIC_ID_OVERFLOW; id++) {
+        if (s_topics[id].used) {
+            topic_hash_insert(id);
+        }
+    }
+}
+
+static int topic_lookup(const char *topic, size_t len) {
+    uint32_t slot = topic_hash(topic, len) % TOPIC_HASH_SLOTS;
+    for (int probe = 0; probe < TOPIC_HASH_SLOTS && s_topic_hash[slot] != 0; probe++) {
+        uint8_t id = s_topic_hash[slot] - 1;
+        if (strncmp(s_topics[id].name, topic, len) == 0 && s_topics[id].name[len] == '\0') {
+            return id;
+        }
+        slot = (slot + 1) % TOPIC_HASH_SLOTS;
+    }
+    return -1;
+}
+
+// 获取主题ID，新主题分配空闲表项或回收已无有效记录的表项
+static uint8_t topic_intern(const char *topic, size_t len) {
+    int found = topic_lookup(topic, len);
+    if (found >= 0) {
+        return (uint8_t)found;
+    }
+
+    int free_id = -1;
+    bool reclaimed = false;
+    for (uint8_t id = 0; id < TOPIC_ID_OVERFLOW; id++) {
+        if (!s_topics[id].used) {
+            free_id = id;
+            break;
+        }
+        if (free_id < 0 && !seq_alive(s_topics[id].last_seq)) {
+            free_id = id;
+            reclaimed = true;
+        }
+    }
+    if (free_id < 0) {
+        return TOPIC_ID_OVERFLOW;
+    }
+
+    topic_entry_t *entry = &s_topics[free_id];
+    memcpy(entry->name, topic, len);
+    entry->name[len] = '\0';
+    entry->last_seq = MSG_STORE_SEQ_NONE;
+    entry->used = true;
+    if (reclaimed) {
+        topic_hash_rebuild();
+    } else {
+        topic_hash_insert((uint8_t)free_id);
+    }
+    filter_update_topic_bit((uint8_t)free_id);
+    return (uint8_t)free_id;
+}
+
+// 判断两段数据区是否重叠（零长度记录落在新区间内也视为重叠）
+static bool arena_overlap(uint32_t off, uint32_t len, uint32_t start, uint32_t size) {
+    if (off >= start && off < start + size) {
+        return true;
+    }
+    return off < start && off + len > start;
+}
+
+// 在数据区中预留空间，必要时淘汰最旧的记录
+static uint32_t arena_reserve(uint32_t len) {
+    if (s_arena_head + len > MSG_STORE_ARENA_SIZE) {
+        // 尾部空间不足时回绕，先淘汰仍位于尾部的上一圈记录
+        uint32_t old_head = s_arena_head;
+        while (record_count() > 0 && record_at(s_oldest_seq)->data_off >= old_head) {
+            s_oldest_seq++;
+        }
+        s_arena_head = 0;
+    }
+    while (record_count() > 0) {
+        const msg_record_t *oldest = record_at(s_oldest_seq);
+        if (!arena_overlap(oldest->data_off, oldest->topic_len + oldest->payload_len,
+                           s_arena_head, len)) {
+            break;
+        }
+        s_oldest_seq++;
+    }
+    uint32_t off = s_arena_head;
+    s_arena_head += len;
+    return off;
+}
+
+static bool record_matches(const msg_record_t *rec) {
+    if (!s_filter_active) {
+        return true;
+    }
+    if (rec->flags & MSG_FLAG_SYSTEM) {
+        return false;  // 过滤时不显示系统消息
+    }
+    const uint8_t *data = s_arena + rec->data_off;
+    if (s_filter.topic_pattern[0] != '\0') {
+        if (!(s_filter_topics & (1ULL << rec->topic_id))) {
+            return false;
+        }
+        if (rec->topic_id == TOPIC_ID_OVERFLOW &&
+            !msg_topic_matches(s_filter.topic_pattern, (const char *)data, rec->topic_len)) {
+            return false;
+        }
+    }
+    if (s_filter.payload_substr[0] != '\0' &&
+        !mem_contains(data + rec->topic_len, rec->payload_len, s_filter.payload_substr)) {
+        return false;
+    }
+    return true;
+}
+
+bool msg_store_init(void) {
+    if (s_records != NULL) {
+        return true;
+    }
+    s_mutex = xSemaphoreCreateMutex();
+    s_records = heap_caps_calloc(MSG_STORE_CAPACITY, sizeof(msg_record_t),
+                                 MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    s_arena = heap_caps_malloc(MSG_STORE_ARENA_SIZE, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (s_records == NULL || s_arena == NULL) {
+        // 无PSRAM时退回内部RAM
+        heap_caps_free(s_records);
+        heap_caps_free(s_arena);
+        s_records = heap_caps_calloc(MSG_STORE_CAPACITY, sizeof(msg_record_t), MALLOC_CAP_8BIT);
+        s_arena = heap_caps_malloc(MSG_STORE_ARENA_SIZE, MALLOC_CAP_8BIT);
+    }
+    if (s_mutex == NULL || s_records == NULL || s_arena == NULL) {
+        ESP_LOGE(TAG, "消息存储内存分配失败");
+        return false;
+    }
+    msg_store_clear();
+    ESP_LOGI(TAG, "消息存储初始化成功: %d条记录, 数据区%dKB",
+             MSG_STORE_CAPACITY, MSG_STORE_ARENA_SIZE / 1024);
+    return true;
+}
+
+void msg_store_clear(void) {
+    if (s_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    s_oldest_seq = s_next_seq;  // 序号不回退，旧的倒排链自然失效
+    s_arena_head = 0;
+    memset(s_topics, 0, sizeof(s_topics));
+    memset(s_topic_hash, 0, sizeof(s_topic_hash));
+    s_topics[TOPIC_ID_OVERFLOW].used = true;
+    s_filter_topics = 0;
+    filter_update_topic_bit(TOPIC_ID_OVERFLOW);
+    xSemaphoreGive(s_mutex);
+}
+
+uint32_t msg_store_append(const char *topic, const void *payload, size_t payload_len,
+                          int qos, uint8_t flags, int64_t rx_time_us) {
+    if (s_records == NULL || topic == NULL || (payload == NULL && payload_len > 0)) {
+        return MSG_STORE_SEQ_NONE;
+    }
+
+    size_t topic_len = strnlen(topic, MSG_STORE_TOPIC_LEN - 1);
+    if (payload_len > MAX_BLOB_LEN - topic_len) {
+        payload_len = MAX_BLOB_LEN - topic_len;
+    }
+
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+
+    if (record_count() >= MSG_STORE_CAPACITY) {
+        s_oldest_seq++;
+    }
+    uint32_t off = arena_reserve(topic_len + payload_len);
+    memcpy(s_arena + off, topic, topic_len);
+    if (payload_len > 0) {
+        memcpy(s_arena + off + topic_len, payload, payload_len);
+    }
+
+    uint32_t seq = s_next_seq++;
+    msg_record_t *rec = record_at(seq);
+    rec->seq = seq;
+    rec->data_off = off;
+    rec->topic_len = topic_len;
+    rec->payload_len = payload_len;
+    rec->qos = qos;
+    rec->flags = flags;
+    rec->rx_time_us = rx_time_us;
+
+    if (flags & MSG_FLAG_SYSTEM) {
+        rec->topic_id = TOPIC_ID_SYSTEM;
+        rec->prev_same_topic = MSG_STORE_SEQ_NONE;
+    } else {
+        uint8_t id = topic_intern(topic, topic_len);
+        rec->topic_id = id;
+        rec->prev_same_topic = s_topics[id].last_seq;
+        s_topics[id].last_seq = seq;
+    }
+
+    xSemaphoreGive(s_mutex);
+    return seq;
+}
+
+bool msg_store_get(uint32_t seq, msg_record_t *rec, char *topic,
+                   uint8_t *payload, size_t payload_size) {
+    if (s_records == NULL || rec == NULL) {
+        return false;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    bool alive = seq_alive(seq);
+    if (alive) {
+        *rec = *record_at(seq);
+        const uint8_t *data = s_arena + rec->data_off;
+        if (topic != NULL) {
+            memcpy(topic, data, rec->topic_len);
+            topic[rec->topic_len] = '\0';
+        }
+        if (payload != NULL && payload_size > 0) {
+            size_t n = rec->payload_len < payload_size ? rec->payload_len : payload_size;
+            memcpy(payload, data + rec->topic_len, n);
+        }
+    }
+    xSemaphoreGive(s_mutex);
+    return alive;
+}
+
+void msg_store_set_filter(const msg_filter_t *filter) {
+    if (s_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    if (filter == NULL) {
+        memset(&s_filter, 0, sizeof(s_filter));
+    } else {
+        s_filter = *filter;
+        s_filter.topic_pattern[sizeof(s_filter.topic_pattern) - 1] = '\0';
+        s_filter.payload_substr[sizeof(s_filter.payload_substr) - 1] = '\0';
+    }
+    s_filter_active = s_filter.topic_pattern[0] != '\0' || s_filter.payload_substr[0] != '\0';
+
+    // 主题模式只需对主题表编译一次，而不是对每条记录做字符串匹配
+    s_filter_topics = 0;
+    for (uint8_t id = 0; id < MSG_STORE_MAX_TOPICS; id++) {
+        filter_update_topic_bit(id);
+    }
+    xSemaphoreGive(s_mutex);
+}
+
+bool msg_store_filter_active(void) {
+    return s_filter_active;
+}
+
+void msg_store_get_filter(msg_filter_t *filter) {
+    if (s_mutex == NULL || filter == NULL) {
+        return;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    *filter = s_filter;
+    xSemaphoreGive(s_mutex);
+}
+
+bool msg_filter_matches(const msg_filter_t *filter, const char *topic, size_t topic_len,
+                        const uint8_t *payload, size_t payload_len, uint8_t flags) {
+    if (filter == NULL || (filter->topic_pattern[0] == '\0' && filter->payload_substr[0] == '\0')) {
+        return true;
+    }
+    if (flags & MSG_FLAG_SYSTEM) {
+        return false;
+    }
+    if (filter->topic_pattern[0] != '\0' && !msg_topic_matches(filter->topic_pattern, topic, topic_len)) {
+        return false;
+    }
+    return mem_contains(payload, payload_len, filter->payload_substr);
+}
+
+bool msg_store_match(uint32_t seq) {
+    if (s_mutex == NULL) {
+        return false;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    bool match = seq_alive(seq) && record_matches(record_at(seq));
+    xSemaphoreGive(s_mutex);
+    return match;
+}
+
+size_t msg_store_query(uint32_t *out_seqs, size_t max_results) {
+    size_t n = 0;
+    if (s_mutex == NULL || out_seqs == NULL || max_results == 0) {
+        return 0;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+
+    if (!s_filter_active || s_filter.topic_pattern[0] == '\0') {
+        // 无主题条件：从新到旧顺序扫描
+        for (uint32_t seq = s_next_seq - 1; seq >= s_oldest_seq && seq != MSG_STORE_SEQ_NONE; seq--) {
+            if (record_matches(record_at(seq))) {
+                out_seqs[n++] = seq;
+                if (n >= max_results) {
+                    break;
+                }
+            }
+        }
+    } else {
+        // 有主题条件：沿匹配主题的倒排链做多路归并，每步取序号最大的链头
+        uint32_t heads[MSG_STORE_MAX_TOPICS];
+        int k = 0;
+        for (uint8_t id = 0; id < MSG_STORE_MAX_TOPICS; id++) {
+            if ((s_filter_topics & (1ULL << id)) && seq_alive(s_topics[id].last_seq)) {
+                heads[k] = s_topics[id].last_seq;
+                k++;
+            }
+        }
+        while (k > 0 && n < max_results) {
+            int best = 0;
+            for (int i = 1; i < k; i++) {
+                if (heads[i] > heads[best]) {
+                    best = i;
+                }
+            }
+            const msg_record_t *rec = record_at(heads[best]);
+            if (record_matches(rec)) {
+                out_seqs[n++] = rec->seq;
+            }
+            uint32_t prev = rec->prev_same_topic;
+            if (seq_alive(prev)) {
+                heads[best] = prev;
+            } else {
+                // 该链已耗尽，用最后一条链替换
+                k--;
+                heads[best] = heads[k];
+            }
+        }
+    }
+
+    xSemaphoreGive(s_mutex);
+    return n;
+}
+
+size_t msg_store_list_topics(char (*names)[MSG_STORE_TOPIC_LEN], size_t max_topics) {
+    uint8_t ids[MSG_STORE_MAX_TOPICS];
+    size_t n = 0;
+    if (s_mutex == NULL || names == NULL) {
+        return 0;
+    }
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    for (uint8_t id = 0; id < TOPIC_ID_OVERFLOW; id++) {
+        if (s_topics[id].used && seq_alive(s_topics[id].last_seq)) {
+            // 按最近活跃程度插入排序
+            size_t pos = n;
+            while (pos > 0 && s_topics[ids[pos - 1]].last_seq < s_topics[id].last_seq) {
+                ids[pos] = ids[pos - 1];
+                pos--;
+            }
+            ids[pos] = id;
+            n++;
+        }
+    }
+    if (n > max_topics) {
+        n = max_topics;
+    }
+    for (size_t i = 0; i < n; i++) {
+        strcpy(names[i], s_topics[ids[i]].name);
+    }
+    xSemaphoreGive(s_mutex);
+    return n;
+}
+
+size_t msg_store_topic_history(const char *topic, uint32_t *out_seqs, size_t max_results) {
+    size_t n = 0;
+    if (s_mutex == NULL || topic == NULL || out_seqs == NULL) {
+        return 0;
+    }
+    size_t len = strlen(topic);
+    xSemaphoreTake(s_mutex, portMAX_DELAY);
+    int id = topic_lookup(topic, len);
+    bool shared = id < 0;
+    uint32_t seq = shared ? s_topics[TOPIC_ID_OVERFLOW].last_seq : s_topics[id].last_seq;
+    while (n < max_results && seq_alive(seq)) {
+        const msg_record_t *rec = record_at(seq);
+        // 溢出桶中混有多个主题，需要逐条比较主题字符串
+        if (!shared || (rec->topic_len == len && memcmp(s_arena + rec->data_off, topic, len) == 0)) {
+            out_seqs[n++] = seq;
+        }
+        seq = rec->prev_same_topic;
+    }
+    xSemaphoreGive(s_mutex);
+    return n;
+}
+
+uint32_t msg_store_oldest_seq(void) {
+    return s_oldest_seq;
+}
+
+uint32_t msg_store_newest_seq(void) {
+    return s_next_seq - 1;
+}
@@ -0,0 +1,488 @@
+#include "mqtt_payload_format.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_message_store.h"
+
+static const char *TAG = "MSG_FORMAT";
+
+#define MSG_FMT_PAYLOAD_MAX     1024    ///< 格式化时读取的载荷上限
+#define MSG_FMT_BIN_PREVIEW     12      ///< 单行预览中显示的二进制字节数
+
+/**
+ * @brief LRU缓存槽位
+ */
+typedef struct {
+    uint32_t seq;       ///< 缓存的记录序号，MSG_STORE_SEQ_NONE表示空闲
+    uint32_t last_use;  ///< 最近一次使用的时钟值
+} fmt_slot_t;
+
+/**
+ * @brief 定长槽位的LRU缓存
+ */
+typedef struct {
+    fmt_slot_t *slots;
+    char *text;          ///< slot_count * slot_size 的文本区
+    size_t slot_count;
+    size_t slot_size;
+    uint32_t clock;
+} fmt_cache_t;
+
+/**
+ * @brief 带边界检查的输出缓冲区
+ */
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool truncated;
+} fmt_out_t;
+
+static fmt_cache_t s_line_cache = {.slot_count = MSG_FMT_LINE_SLOTS, .slot_size = MSG_FMT_LINE_LEN};
+static fmt_cache_t s_detail_cache = {.slot_count = MSG_FMT_DETAIL_SLOTS, .slot_size = MSG_FMT_DETAIL_LEN};
+static uint8_t *s_payload = NULL;   ///< 格式化时的载荷读取缓冲区
+static time_t s_prefix_sec = -1;    ///< s_prefix对应的秒
+static char s_prefix[12];           ///< 缓存的"时:分:秒"前缀
+static int32_t s_seq_offset = 0;    ///< 单行预览显示序号与存储序号之差
+
+static void *fmt_alloc(size_t size) {
+    void *p = heap_caps_calloc(1, size, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (p == NULL) {
+        p = heap_caps_calloc(1, size, MALLOC_CAP_8BIT);
+    }
+    return p;
+}
+
+static bool cache_alloc(fmt_cache_t *c) {
+    c->slots = fmt_alloc(c->slot_count * sizeof(fmt_slot_t));
+    c->text = fmt_alloc(c->slot_count * c->slot_size);
+    return c->slots != NULL && c->text != NULL;
+}
+
+static void cache_reset(fmt_cache_t *c) {
+    if (c->slots != NULL) {
+        memset(c->slots, 0, c->slot_count * sizeof(fmt_slot_t));
+    }
+    c->clock = 0;
+}
+
+/**
+ * @brief 查找缓存，未命中时淘汰最久未使用的槽位并返回其文本区
+ * @param c 缓存
+ * @param seq 记录序号
+ * @param[out] hit 是否命中
+ * @param[out] slot_idx 槽位下标
+ * @return 槽位文本区
+ */
+static char *cache_lookup(fmt_cache_t *c, uint32_t seq, bool *hit, size_t *slot_idx) {
+    size_t victim = 0;
+
+    c->clock++;
+    for (size_t i = 0; i < c->slot_count; i++) {
+        if (c->slots[i].seq == seq) {
+            c->slots[i].last_use = c->clock;
+            *hit = true;
+            *slot_idx = i;
+            return c->text + i * c->slot_size;
+        }
+        if (c->slots[i].seq == MSG_STORE_SEQ_NONE) {
+            if (c->slots[victim].seq != MSG_STORE_SEQ_NONE) {
+                victim = i;
+            }
+        } else if (c->slots[victim].seq != MSG_STORE_SEQ_NONE &&
+                   c->slots[i].last_use < c->slots[victim].last_use) {
+            victim = i;
+        }
+    }
+    c->slots[victim].seq = seq;
+    c->slots[victim].last_use = c->clock;
+    *hit = false;
+    *slot_idx = victim;
+    return c->text + victim * c->slot_size;
+}
+
+static void out_putc(fmt_out_t *o, char ch) {
+    if (o->len + 1 < o->size) {
+        o->buf[o->len++] = ch;
+    } else {
+        o->truncated = true;
+    }
+}
+
+static void out_puts(fmt_out_t *o, const char *s) {
+    while (*s) {
+        out_putc(o, *s++);
+    }
+}
+
+static void out_finish(fmt_out_t *o, const char *trunc_mark) {
+    if (o->truncated) {
+        size_t mark_len = strlen(trunc_mark);
+        size_t pos = o->size - 1 > mark_len ? o->size - 1 - mark_len : 0;
+        if (pos > o->len) {
+            pos = o->len;
+        }
+        // 不在UTF-8多字节字符中间截断
+        while (pos > 0 && ((uint8_t)o->buf[pos] & 0xC0) == 0x80) {
+            pos--;
+        }
+        o->len = pos;
+        o->truncated = false;
+        out_puts(o, trunc_mark);
+    }
+    o->buf[o->len] = '\0';
+}
+
+// "时:分:秒.毫秒"；同一秒内的消息复用缓存的前缀，不再重复调用localtime_r/strftime
+static void get_time_string(int64_t wall_ms, char *buffer, size_t size) {
+    time_t sec = (time_t)(wall_ms / 1000);
+
+    if (sec != s_prefix_sec) {
+        struct tm tm_info;
+        localtime_r(&sec, &tm_info);
+        strftime(s_prefix, sizeof(s_prefix), "%H:%M:%S", &tm_info);
+        s_prefix_sec = sec;
+    }
+    snprintf(buffer, size, "%s.%03d", s_prefix, (int)(wall_ms % 1000));
+}
+
+int64_t msg_format_wall_ms(int64_t rx_time_us) {
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    int64_t offset_us = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - esp_timer_get_time();
+    return (rx_time_us + offset_us) / 1000;
+}
+
+// 返回合法UTF-8序列的长度，不合法返回0（数据末尾被截断的序列视为合法）
+static size_t utf8_seq_len(const uint8_t *p, size_t remain) {
+    size_t n;
+
+    if (p[0] < 0x80) {
+        return 1;
+    } else if ((p[0] & 0xE0) == 0xC0) {
+        n = 2;
+    } else if ((p[0] & 0xF0) == 0xE0) {
+        n = 3;
+    } else if ((p[0] & 0xF8) == 0xF0) {
+        n = 4;
+    } else {
+        return 0;
+    }
+    if (n > remain) {
+        n = remain;
+    }
+    for (size_t i = 1; i < n; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+    }
+    return n;
+}
+
+msg_payload_kind_t msg_payload_classify(const uint8_t *data, size_t len) {
+    size_t i = 0;
+
+    while (i < len) {
+        uint8_t c = data[i];
+        if ((c < 0x20 && c != '\t' && c != '\r' && c != '\n') || c == 0x7F) {
+            return MSG_PAYLOAD_BINARY;
+        }
+        size_t n = utf8_seq_len(data + i, len - i);
+        if (n == 0) {
+            return MSG_PAYLOAD_BINARY;
+        }
+        i += n;
+    }
+
+    // 结构检查：以{或[开头，括号在字符串外配对，并以对应的括号结尾
+    size_t start = 0;
+    while (start < len && (data[start] == ' ' || data[start] == '\t' ||
+                           data[start] == '\r' || data[start] == '\n')) {
+        start++;
+    }
+    if (start == len || (data[start] != '{' && data[start] != '[')) {
+        return MSG_PAYLOAD_TEXT;
+    }
+
+    int depth = 0;
+    bool in_str = false;
+    bool esc = false;
+    size_t end = start;
+    for (i = start; i < len; i++) {
+        char c = (char)data[i];
+        if (in_str) {
+            if (esc) {
+                esc = false;
+            } else if (c == '\\') {
+                esc = true;
+            } else if (c == '"') {
+                in_str = false;
+            }
+            continue;
+        }
+        if (c == '"') {
+            in_str = true;
+        } else if (c == '{' || c == '[') {
+            depth++;
+        } else if (c == '}' || c == ']') {
+            if (--depth < 0) {
+                return MSG_PAYLOAD_TEXT;
+            }
+            end = i;
+        } else if (depth == 0 && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+            return MSG_PAYLOAD_TEXT;
+        }
+    }
+    return (depth == 0 && !in_str && end > start) ? MSG_PAYLOAD_JSON : MSG_PAYLOAD_TEXT;
+}
+
+static void out_indent(fmt_out_t *o, int depth) {
+    out_putc(o, '\n');
+    for (int i = 0; i < depth * MSG_FMT_JSON_INDENT; i++) {
+        out_putc(o, ' ');
+    }
+}
+
+// 流式JSON美化（不建立语法树，仅按结构字符插入换行和缩进）
+static void format_json(fmt_out_t *o, const uint8_t *data, size_t len) {
+    int depth = 0;
+    bool in_str = false;
+    bool esc = false;
+
+    for (size_t i = 0; i < len && !o->truncated; i++) {
+        char c = (char)data[i];
+        if (in_str) {
+            out_putc(o, c);
+            if (esc) {
+                esc = false;
+            } else if (c == '\\') {
+                esc = true;
+            } else if (c == '"') {
+                in_str = false;
+            }
+            continue;
+        }
+        switch (c) {
+        case ' ': case '\t': case '\r': case '\n':
+            break;
+        case '"':
+            in_str = true;
+            out_putc(o, c);
+            break;
+        case '{': case '[': {
+            size_t j = i + 1;
+            while (j < len && (data[j] == ' ' || data[j] == '\t' || data[j] == '\r' || data[j] == '\n')) {
+                j++;
+            }
+            out_putc(o, c);
+            if (j < len && (data[j] == '}' || data[j] == ']')) {
+                // 空对象/数组保持在同一行
+                out_putc(o, (char)data[j]);
+                i = j;
+            } else {
+                out_indent(o, ++depth);
+            }
+            break;
+        }
+        case '}': case ']':
+            if (depth > 0) {
+                depth--;
+            }
+            out_indent(o, depth);
+            out_putc(o, c);
+            break;
+        case ',':
+            out_putc(o, c);
+            out_indent(o, depth);
+            break;
+        case ':':
+            out_puts(o, ": ");
+            break;
+        default:
+            out_putc(o, c);
+            break;
+        }
+    }
+}
+
+// 十六进制转储："0000  01 02 ..  |..|"
+static void format_hexdump(fmt_out_t *o, const uint8_t *data, size_t len) {
+    char tmp[8];
+
+    for (size_t off = 0; off < len && !o->truncated; off += MSG_FMT_HEX_PER_LINE) {
+        snprintf(tmp, sizeof(tmp), "%04X ", (unsigned)off);
+        out_puts(o, tmp);
+        for (size_t i = 0; i < MSG_FMT_HEX_PER_LINE; i++) {
+            if (off + i < len) {
+                snprintf(tmp, sizeof(tmp), " %02X", data[off + i]);
+                out_puts(o, tmp);
+            } else {
+                out_puts(o, "   ");
+            }
+        }
+        out_puts(o, "  |");
+        for (size_t i = 0; i < MSG_FMT_HEX_PER_LINE && off + i < len; i++) {
+            uint8_t c = data[off + i];
+            out_putc(o, (c >= 0x20 && c < 0x7F) ? (char)c : '.');
+        }
+        out_puts(o, "|\n");
+    }
+}
+
+// 单行预览的载荷部分
+static void format_preview(fmt_out_t *o, const uint8_t *data, size_t len, size_t total_len) {
+    if (msg_payload_classify(data, len) == MSG_PAYLOAD_BINARY) {
+        char tmp[16];
+        snprintf(tmp, sizeof(tmp), "<bin %uB>", (unsigned)total_len);
+        out_puts(o, tmp);
+        for (size_t i = 0; i < len && i < MSG_FMT_BIN_PREVIEW; i++) {
+            snprintf(tmp, sizeof(tmp), " %02X", data[i]);
+            out_puts(o, tmp);
+        }
+        if (total_len > MSG_FMT_BIN_PREVIEW) {
+            o->truncated = true;
+        }
+        return;
+    }
+    for (size_t i = 0; i < len && !o->truncated; i++) {
+        char c = (char)data[i];
+        out_putc(o, (c == '\n' || c == '\r' || c == '\t') ? ' ' : c);
+    }
+    if (total_len > len) {
+        o->truncated = true;
+    }
+}
+
+bool msg_format_init(void) {
+    if (s_payload != NULL) {
+        return true;
+    }
+    s_payload = fmt_alloc(MSG_FMT_PAYLOAD_MAX);
+    if (s_payload == NULL || !cache_alloc(&s_line_cache) || !cache_alloc(&s_detail_cache)) {
+        ESP_LOGE(TAG, "格式化缓存内存分配失败");
+        return false;
+    }
+    return true;
+}
+
+void msg_format_invalidate(void) {
+    cache_reset(&s_line_cache);
+    cache_reset(&s_detail_cache);
+}
+
+void msg_format_set_seq_offset(int32_t offset) {
+    if (offset != s_seq_offset) {
+        s_seq_offset = offset;
+        cache_reset(&s_line_cache);     // 缓存的行里序号已过时
+    }
+}
+
+void msg_format_record_line(const msg_record_t *rec, int64_t wall_ms, const char *topic,
+                            const uint8_t *payload, size_t len, char *out, size_t size) {
+    char time_str[24];
+    char head[MSG_STORE_TOPIC_LEN + 48];
+
+    get_time_string(wall_ms, time_str, sizeof(time_str));
+    if (rec->flags & MSG_FLAG_SYSTEM) {
+        snprintf(head, sizeof(head), "[SYS] %s [%s] ", time_str, topic);
+    } else {
+        snprintf(head, sizeof(head), "[%lu] %s [Q%d%s] %s: ",
+                 (unsigned long)rec->seq, time_str, rec->qos,
+                 (rec->flags & MSG_FLAG_RETAINED) ? "R" : "", topic);
+    }
+
+    fmt_out_t o = {.buf = out, .size = size};
+    out_puts(&o, head);
+    format_preview(&o, payload, len, rec->payload_len);
+    out_finish(&o, "...");
+}
+
+const char *msg_format_line(uint32_t seq) {
+    msg_record_t rec;
+    char topic[MSG_STORE_TOPIC_LEN];
+    bool hit;
+    size_t slot;
+
+    if (s_payload == NULL) {
+        return NULL;
+    }
+    char *text = cache_lookup(&s_line_cache, seq, &hit, &slot);
+    if (hit) {
+        return text;
+    }
+
+    // 预览最多只需要一行长度的载荷
+    if (!msg_store_get(seq, &rec, topic, s_payload, MSG_FMT_LINE_LEN)) {
+        s_line_cache.slots[slot].seq = MSG_STORE_SEQ_NONE;
+        return NULL;
+    }
+    size_t len = rec.payload_len < MSG_FMT_LINE_LEN ? rec.payload_len : MSG_FMT_LINE_LEN;
+    rec.seq += s_seq_offset;
+    msg_format_record_line(&rec, msg_format_wall_ms(rec.rx_time_us), topic, s_payload, len,
+                           text, MSG_FMT_LINE_LEN);
+    return text;
+}
+
+const char *msg_format_detail(uint32_t seq, char *topic) {
+    msg_record_t rec;
+    char topic_buf[MSG_STORE_TOPIC_LEN];
+    bool hit;
+    size_t slot;
+
+    if (s_payload == NULL) {
+        return NULL;
+    }
+    if (topic == NULL) {
+        topic = topic_buf;
+    }
+    char *text = cache_lookup(&s_detail_cache, seq, &hit, &slot);
+    if (!msg_store_get(seq, &rec, topic, hit ? NULL : s_payload, MSG_FMT_PAYLOAD_MAX)) {
+        s_detail_cache.slots[slot].seq = MSG_STORE_SEQ_NONE;
+        return NULL;
+    }
+    if (hit) {
+        return text;
+    }
+
+    size_t len = rec.payload_len < MSG_FMT_PAYLOAD_MAX ? rec.payload_len : MSG_FMT_PAYLOAD_MAX;
+    fmt_out_t o = {.buf = text, .size = MSG_FMT_DETAIL_LEN};
+
+    // 首行：接收时间和与同主题上一条消息的间隔
+    char head[64];
+    msg_record_t prev;
+    get_time_string(msg_format_wall_ms(rec.rx_time_us), head, sizeof(head));
+    out_puts(&o, "rx ");
+    out_puts(&o, head);
+    if (rec.prev_same_topic != MSG_STORE_SEQ_NONE &&
+        msg_store_get(rec.prev_same_topic, &prev, NULL, NULL, 0)) {
+        int64_t gap_us = rec.rx_time_us - prev.rx_time_us;
+        snprintf(head, sizeof(head), "  +%lld.%03lld ms",
+                 (long long)(gap_us / 1000), (long long)(gap_us % 1000));
+        out_puts(&o, head);
+    }
+    out_putc(&o, '\n');
+
+    switch (msg_payload_classify(s_payload, len)) {
+    case MSG_PAYLOAD_JSON:
+        format_json(&o, s_payload, len);
+        break;
+    case MSG_PAYLOAD_BINARY:
+        format_hexdump(&o, s_payload, len);
+        break;
+    default:
+        for (size_t i = 0; i < len; i++) {
+            out_putc(&o, (char)s_payload[i]);
+        }
+        break;
+    }
+    if (rec.payload_len > len) {
+        o.truncated = true;
+    }
+    out_finish(&o, "\n...");
+    return text;
+}
@@ -0,0 +1,361 @@
+#include "mqtt_topic_series.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "mqtt_message_store.h"
+
+static const char *TAG = "SERIES";
+
+#define SERIES_MASK         (SERIES_CAPACITY - 1)
+#define SERIES_NUM_LEN      32      ///< 数字字符串最大长度
+
+/**
+ * @brief 样本
+ */
+typedef struct {
+    uint32_t t_ms;  ///< 接收时间（毫秒）
+    float value;    ///< 数值
+} series_sample_t;
+
+static series_sample_t *s_samples = NULL;
+static uint32_t s_head = 0;         ///< 下一个写入位置（累计计数）
+static uint32_t s_count = 0;        ///< 有效样本数
+static uint32_t s_total = 0;        ///< 选中以来累计样本数
+static bool s_dirty = false;
+static char s_topic[MSG_STORE_TOPIC_LEN];
+static char s_field[SERIES_FIELD_LEN];
+
+static inline const series_sample_t *sample_at(uint32_t i) {
+    // i为从旧到新的下标
+    return &s_samples[(s_head - s_count + i) & SERIES_MASK];
+}
+
+static void series_push(uint32_t t_ms, float value) {
+    s_samples[s_head & SERIES_MASK] = (series_sample_t){.t_ms = t_ms, .value = value};
+    s_head++;
+    if (s_count < SERIES_CAPACITY) {
+        s_count++;
+    }
+    s_total++;
+    s_dirty = true;
+}
+
+static bool parse_number(const uint8_t *p, size_t len, float *value) {
+    char num[SERIES_NUM_LEN];
+    char *end;
+
+    if (len == 0 || len >= sizeof(num)) {
+        return false;
+    }
+    memcpy(num, p, len);
+    num[len] = '\0';
+    float v = strtof(num, &end);
+    if (end == num || *end != '\0') {
+        return false;
+    }
+    *value = v;
+    return true;
+}
+
+// 从pos开始查找下一个值为数字的JSON键值对
+static bool json_next_number(const uint8_t *p, size_t len, size_t *pos,
+                             char *key, size_t key_size, float *value) {
+    size_t i = *pos;
+
+    while (i < len) {
+        if (p[i] != '"') {
+            i++;
+            continue;
+        }
+        size_t ks = ++i;
+        bool esc = false;
+        while (i < len) {
+            if (esc) {
+                esc = false;
+            } else if (p[i] == '\\') {
+                esc = true;
+            } else if (p[i] == '"') {
+                break;
+            }
+            i++;
+        }
+        if (i >= len) {
+            break;
+        }
+        size_t ke = i++;
+
+        size_t j = i;
+        while (j < len && isspace(p[j])) {
+            j++;
+        }
+        if (j >= len || p[j] != ':') {
+            continue;   // 不是键，而是字符串值
+        }
+        j++;
+        while (j < len && isspace(p[j])) {
+            j++;
+        }
+        size_t ns = j;
+        while (j < len && (isdigit(p[j]) || p[j] == '-' || p[j] == '+' ||
+                           p[j] == '.' || p[j] == 'e' || p[j] == 'E')) {
+            j++;
+        }
+        if (j > ns && parse_number(p + ns, j - ns, value)) {
+            size_t kl = ke - ks < key_size - 1 ? ke - ks : key_size - 1;
+            memcpy(key, p + ks, kl);
+            key[kl] = '\0';
+            *pos = j;
+            return true;
+        }
+        i = j;
+    }
+    *pos = len;
+    return false;
+}
+
+bool series_parse_value(const uint8_t *payload, size_t len, const char *field, float *value) {
+    char key[SERIES_FIELD_LEN];
+    size_t pos = 0;
+
+    if (payload == NULL || value == NULL) {
+        return false;
+    }
+    if (field == NULL || field[0] == '\0') {
+        // 纯数字载荷
+        size_t s = 0, e = len;
+        while (s < e && isspace(payload[s])) {
+            s++;
+        }
+        while (e > s && isspace(payload[e - 1])) {
+            e--;
+        }
+        if (parse_number(payload + s, e - s, value)) {
+            return true;
+        }
+    }
+    while (json_next_number(payload, len, &pos, key, sizeof(key), value)) {
+        if (field == NULL || field[0] == '\0' || strcmp(key, field) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t series_numeric_keys(const uint8_t *payload, size_t len,
+                           char (*keys)[SERIES_FIELD_LEN], size_t max_keys) {
+    char key[SERIES_FIELD_LEN];
+    size_t pos = 0;
+    size_t n = 0;
+    float value;
+
+    while (n < max_keys && json_next_number(payload, len, &pos, key, sizeof(key), &value)) {
+        bool dup = false;
+        for (size_t i = 0; i < n && !dup; i++) {
+            dup = strcmp(keys[i], key) == 0;
+        }
+        if (!dup) {
+            strcpy(keys[n++], key);
+        }
+    }
+    return n;
+}
+
+bool series_init(void) {
+    if (s_samples != NULL) {
+        return true;
+    }
+    s_samples = heap_caps_calloc(SERIES_CAPACITY, sizeof(series_sample_t),
+                                 MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (s_samples == NULL) {
+        s_samples = heap_caps_calloc(SERIES_CAPACITY, sizeof(series_sample_t), MALLOC_CAP_8BIT);
+    }
+    if (s_samples == NULL) {
+        ESP_LOGE(TAG, "序列缓冲区内存分配失败");
+        return false;
+    }
+    return true;
+}
+
+void series_select(const char *topic, const char *field) {
+    uint8_t payload[256];
+    msg_record_t rec;
+    float value;
+
+    s_head = 0;
+    s_count = 0;
+    s_total = 0;
+    s_dirty = true;
+    strncpy(s_topic, topic ? topic : "", sizeof(s_topic) - 1);
+    s_topic[sizeof(s_topic) - 1] = '\0';
+    strncpy(s_field, field ? field : "", sizeof(s_field) - 1);
+    s_field[sizeof(s_field) - 1] = '\0';
+    if (s_samples == NULL || s_topic[0] == '\0') {
+        return;
+    }
+
+    // 从消息存储回填历史（倒排链为从新到旧，分批取回后逆序写入）
+    uint32_t *seqs = heap_caps_malloc(SERIES_CAPACITY * sizeof(uint32_t), MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+    if (seqs == NULL) {
+        return;
+    }
+    size_t n = msg_store_topic_history(s_topic, seqs, SERIES_CAPACITY);
+    for (size_t i = n; i-- > 0;) {
+        if (!msg_store_get(seqs[i], &rec, NULL, payload, sizeof(payload))) {
+            continue;
+        }
+        size_t len = rec.payload_len < sizeof(payload) ? rec.payload_len : sizeof(payload);
+        if (series_parse_value(payload, len, s_field, &value)) {
+            series_push((uint32_t)(rec.rx_time_us / 1000), value);
+        }
+    }
+    heap_caps_free(seqs);
+    ESP_LOGI(TAG, "选择主题 %s 字段 \"%s\"，回填%lu个样本", s_topic, s_field, (unsigned long)s_count);
+}
+
+const char *series_topic(void) {
+    return s_topic;
+}
+
+const char *series_field(void) {
+    return s_field;
+}
+
+void series_feed(const char *topic, const void *payload, size_t len, int64_t rx_time_us) {
+    float value;
+
+    if (s_samples == NULL || s_topic[0] == '\0' || strcmp(topic, s_topic) != 0) {
+        return;
+    }
+    if (series_parse_value(payload, len, s_field, &value)) {
+        series_push((uint32_t)(rx_time_us / 1000), value);
+    }
+}
+
+bool series_dirty(void) {
+    return s_dirty;
+}
+
+void series_invalidate(void) {
+    s_dirty = true;
+}
+
+// 每桶输出最小值和最大值（按出现的先后顺序），保证峰值不被降采样抹掉
+static size_t decimate_minmax(float *out, size_t max_points) {
+    size_t buckets = max_points / 2;
+    size_t n = 0;
+
+    for (size_t b = 0; b < buckets; b++) {
+        uint32_t start = (uint32_t)((uint64_t)b * s_count / buckets);
+        uint32_t end = (uint32_t)((uint64_t)(b + 1) * s_count / buckets);
+        if (start >= end) {
+            continue;
+        }
+        uint32_t imin = start, imax = start;
+        for (uint32_t i = start + 1; i < end; i++) {
+            float v = sample_at(i)->value;
+            if (v < sample_at(imin)->value) {
+                imin = i;
+            }
+            if (v > sample_at(imax)->value) {
+                imax = i;
+            }
+        }
+        out[n++] = sample_at(imin < imax ? imin : imax)->value;
+        out[n++] = sample_at(imin < imax ? imax : imin)->value;
+    }
+    return n;
+}
+
+// Largest-Triangle-Three-Buckets：每桶选取与前一选中点、下一桶均值构成最大三角形的点
+static size_t decimate_lttb(float *out, size_t max_points) {
+    size_t n = 0;
+    uint32_t a = 0;
+    float every = (float)(s_count - 2) / (float)(max_points - 2);
+    uint32_t t0 = sample_at(0)->t_ms;
+
+    out[n++] = sample_at(0)->value;
+    for (size_t b = 0; b < max_points - 2; b++) {
+        uint32_t avg_start = (uint32_t)((b + 1) * every) + 1;
+        uint32_t avg_end = (uint32_t)((b + 2) * every) + 1;
+        if (avg_end > s_count) {
+            avg_end = s_count;
+        }
+        float avg_x = 0, avg_y = 0;
+        for (uint32_t i = avg_start; i < avg_end; i++) {
+            avg_x += (float)(sample_at(i)->t_ms - t0);
+            avg_y += sample_at(i)->value;
+        }
+        if (avg_end > avg_start) {
+            avg_x /= (float)(avg_end - avg_start);
+            avg_y /= (float)(avg_end - avg_start);
+        }
+
+        uint32_t range_start = (uint32_t)(b * every) + 1;
+        uint32_t range_end = (uint32_t)((b + 1) * every) + 1;
+        float ax = (float)(sample_at(a)->t_ms - t0);
+        float ay = sample_at(a)->value;
+        float max_area = -1.0f;
+        uint32_t pick = range_start;
+        for (uint32_t i = range_start; i < range_end; i++) {
+            float x = (float)(sample_at(i)->t_ms - t0);
+            float y = sample_at(i)->value;
+            float area = (ax - avg_x) * (y - ay) - (ax - x) * (avg_y - ay);
+            if (area < 0) {
+                area = -area;
+            }
+            if (area > max_area) {
+                max_area = area;
+                pick = i;
+            }
+        }
+        out[n++] = sample_at(pick)->value;
+        a = pick;
+    }
+    out[n++] = sample_at(s_count - 1)->value;
+    return n;
+}
+
+size_t series_render(float *out, size_t max_points, series_decimate_t mode, series_stats_t *stats) {
+    size_t n = 0;
+
+    s_dirty = false;
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+        stats->total = s_total;
+        stats->count = s_count;
+    }
+    if (s_samples == NULL || s_count == 0 || out == NULL || max_points < 4) {
+        return 0;
+    }
+
+    if (s_count <= max_points) {
+        for (uint32_t i = 0; i < s_count; i++) {
+            out[n++] = sample_at(i)->value;
+        }
+    } else if (mode == SERIES_DECIMATE_MINMAX) {
+        n = decimate_minmax(out, max_points);
+    } else {
+        n = decimate_lttb(out, max_points);
+    }
+
+    if (stats != NULL) {
+        stats->last = sample_at(s_count - 1)->value;
+        stats->min = stats->max = stats->last;
+        for (uint32_t i = 0; i < s_count; i++) {
+            float v = sample_at(i)->value;
+            if (v < stats->min) {
+                stats->min = v;
+            }
+            if (v > stats->max) {
+                stats->max = v;
+            }
+        }
+        uint32_t span_ms = sample_at(s_count - 1)->t_ms - sample_at(0)->t_ms;
+        if (s_count > 1 && span_ms > 0) {
+            stats->rate_hz = (float)(s_count - 1) * 1000.0f / (float)span_ms;
+        }
+    }
+    return n;
+}
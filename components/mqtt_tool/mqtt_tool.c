@@ -18,6 +18,7 @@
 #include "esp_system.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "mqtt_client.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -124,13 +125,15 @@ static void mqtt_tool_event_handler(void *handler_args, esp_event_base_t base, i
         ESP_LOGI(TAG, "MQTT_EVENT_PUBLISHED, msg_id=%d", event->msg_id);
         break;
         
-    case MQTT_EVENT_DATA:
-        ESP_LOGI(TAG, "MQTT_EVENT_DATA");
+    case MQTT_EVENT_DATA: {
+        // 在事件到达时立即打时间戳，之后的排队和显示延迟不影响消息时间
+        int64_t rx_time_us = esp_timer_get_time();
+        ESP_LOGD(TAG, "MQTT_EVENT_DATA");
         if (event->topic && event->topic_len > 0) {
-            ESP_LOGI(TAG, "TOPIC=%.*s", event->topic_len, event->topic);
+            ESP_LOGD(TAG, "TOPIC=%.*s", event->topic_len, event->topic);
         }
         if (event->data && event->data_len > 0) {
-            ESP_LOGI(TAG, "DATA=%.*s", event->data_len, event->data);
+            ESP_LOGD(TAG, "DATA len=%d", event->data_len);
             // 将接收到的消息发送到UI处理
             if (logic_to_ui_queue != NULL) {
                 logic_to_ui_msg_t msg = {
@@ -144,18 +147,23 @@ static void mqtt_tool_event_handler(void *handler_args, esp_event_base_t base, i
                 memcpy(msg.data.mqtt_received.topic, event->topic, topic_copy_len);
                 msg.data.mqtt_received.topic[topic_copy_len] = '\0';
                 
-                // 安全地复制payload，使用实际长度
+                // 安全地复制payload，使用实际长度（保留原始字节，二进制载荷同样有效）
                 int payload_copy_len = (event->data_len < sizeof(msg.data.mqtt_received.payload) - 1) ? 
                                       event->data_len : sizeof(msg.data.mqtt_received.payload) - 1;
                 memcpy(msg.data.mqtt_received.payload, event->data, payload_copy_len);
                 msg.data.mqtt_received.payload[payload_copy_len] = '\0';
+                msg.data.mqtt_received.payload_len = payload_copy_len;
+                msg.data.mqtt_received.qos = event->qos;
+                msg.data.mqtt_received.retained = event->retain;
+                msg.data.mqtt_received.rx_time_us = rx_time_us;
                 
                 // 发送到UI
-                ESP_LOGI(TAG, "Sending MQTT message to UI: topic=%s, payload=%s", msg.data.mqtt_received.topic, msg.data.mqtt_received.payload);
+                ESP_LOGD(TAG, "Sending MQTT message to UI: topic=%s, len=%d", msg.data.mqtt_received.topic, payload_copy_len);
                 xQueueSend(logic_to_ui_queue, &msg, portMAX_DELAY);
             }
         }
         break;
+    }
         
     case MQTT_EVENT_ERROR:
         ESP_LOGE(TAG, "MQTT_EVENT_ERROR");
@@ -0,0 +1,78 @@
+// 曲线界面：手工维护，不在SquareLine工程中，重新导出界面时不会生成或覆盖此文件
+// 写法与生成的界面文件保持一致，变量和事件声明在ui_app.h中
+
+#include "../ui_app.h"
+
+static void ui_ChartScreen_step_0(void)
+{
+    ui_ChartScreen = lv_obj_create(NULL);
+    lv_obj_clear_flag(ui_ChartScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+
+    ui_ChartTopic = lv_dropdown_create(ui_ChartScreen);
+    lv_dropdown_set_options(ui_ChartTopic, "(no topics)");
+    lv_obj_set_width(ui_ChartTopic, 150);
+    lv_obj_set_height(ui_ChartTopic, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_ChartTopic, -81);
+    lv_obj_set_y(ui_ChartTopic, -100);
+    lv_obj_set_align(ui_ChartTopic, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_ChartTopic, LV_OBJ_FLAG_SCROLL_ON_FOCUS);     /// Flags
+
+    ui_ChartField = lv_dropdown_create(ui_ChartScreen);
+    lv_dropdown_set_options(ui_ChartField, "auto");
+    lv_obj_set_width(ui_ChartField, 90);
+    lv_obj_set_height(ui_ChartField, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_ChartField, 43);
+    lv_obj_set_y(ui_ChartField, -100);
+    lv_obj_set_align(ui_ChartField, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_ChartField, LV_OBJ_FLAG_SCROLL_ON_FOCUS);     /// Flags
+}
+
+static void ui_ChartScreen_step_1(void)
+{
+    ui_ChartMode = lv_dropdown_create(ui_ChartScreen);
+    lv_dropdown_set_options(ui_ChartMode, "LTTB\nMin/Max");
+    lv_obj_set_width(ui_ChartMode, 64);
+    lv_obj_set_height(ui_ChartMode, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_ChartMode, 124);
+    lv_obj_set_y(ui_ChartMode, -100);
+    lv_obj_set_align(ui_ChartMode, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_ChartMode, LV_OBJ_FLAG_SCROLL_ON_FOCUS);     /// Flags
+
+    ui_TopicChart = lv_chart_create(ui_ChartScreen);
+    lv_obj_set_width(ui_TopicChart, 312);
+    lv_obj_set_height(ui_TopicChart, 160);
+    lv_obj_set_x(ui_TopicChart, 0);
+    lv_obj_set_y(ui_TopicChart, 10);
+    lv_obj_set_align(ui_TopicChart, LV_ALIGN_CENTER);
+    lv_obj_clear_flag(ui_TopicChart, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+}
+
+static void ui_ChartScreen_step_2(void)
+{
+    ui_ChartStats = lv_label_create(ui_ChartScreen);
+    lv_obj_set_width(ui_ChartStats, 312);
+    lv_obj_set_height(ui_ChartStats, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_x(ui_ChartStats, 0);
+    lv_obj_set_y(ui_ChartStats, 104);
+    lv_obj_set_align(ui_ChartStats, LV_ALIGN_CENTER);
+    lv_label_set_long_mode(ui_ChartStats, LV_LABEL_LONG_DOT);
+    lv_label_set_text(ui_ChartStats, "no numeric data");
+    ui_style_add(ui_ChartStats, UI_STYLE_LABEL_SMALL);
+
+    lv_obj_add_event_cb(ui_ChartScreen, ui_event_ChartScreen, LV_EVENT_ALL, NULL);
+}
+
+// 分步创建：界面缓存在后台预创建时每次定时器只执行预算内的几步（见ui_screen_cache.h）
+static const ui_screen_step_t ui_ChartScreen_step_fns[] = {
+    ui_ChartScreen_step_0,
+    ui_ChartScreen_step_1,
+    ui_ChartScreen_step_2,
+};
+const ui_screen_steps_t ui_ChartScreen_steps = UI_SCREEN_STEPS(ui_ChartScreen_step_fns);
+
+void ui_ChartScreen_screen_init(void)
+{
+    for(size_t i = 0; i < ui_ChartScreen_steps.count; i++) {
+        ui_ChartScreen_steps.steps[i]();
+    }
+}
@@ -2,10 +2,12 @@
 // SquareLine Studio version: SquareLine Studio 1.5.0
 // LVGL version: 8.3.11
 // Project name: MqttTest
+// 创建函数按控件拆成几步（ui_ConnestScreen_steps，在ui_app.c中登记到界面缓存），重新导出后需要同样拆分，否则链接失败
 
 #include "../ui.h"
+#include "../ui_screen_cache.h"
 
-void ui_ConnestScreen_screen_init(void)
+static void ui_ConnestScreen_step_0(void)
 {
     ui_ConnestScreen = lv_obj_create(NULL);
     lv_obj_clear_flag(ui_ConnestScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
@@ -41,7 +43,10 @@ void ui_ConnestScreen_screen_init(void)
     lv_obj_set_y(ui_Label9, 37);
     lv_obj_set_align(ui_Label9, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label9, "Pssword:");
+}
 
+static void ui_ConnestScreen_step_1(void)
+{
     ui_MqttConnect = lv_btn_create(ui_ConnestScreen);
     lv_obj_set_width(ui_MqttConnect, 103);
     lv_obj_set_height(ui_MqttConnect, 48);
@@ -73,7 +78,10 @@ void ui_ConnestScreen_screen_init(void)
     lv_obj_set_y(ui_Label22, -1);
     lv_obj_set_align(ui_Label22, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label22, "Disconnect");
+}
 
+static void ui_ConnestScreen_step_2(void)
+{
     ui_MqttServerUrl = lv_textarea_create(ui_ConnestScreen);
     lv_obj_set_width(ui_MqttServerUrl, 235);
     lv_obj_set_height(ui_MqttServerUrl, 38);
@@ -93,9 +101,10 @@ void ui_ConnestScreen_screen_init(void)
     lv_obj_set_align(ui_MqttServerPort, LV_ALIGN_CENTER);
     lv_textarea_set_text(ui_MqttServerPort, "1883");
     lv_textarea_set_placeholder_text(ui_MqttServerPort, "Placeholder...");
+}
 
-
-
+static void ui_ConnestScreen_step_3(void)
+{
     ui_MqttUser = lv_textarea_create(ui_ConnestScreen);
     lv_obj_set_width(ui_MqttUser, 235);
     lv_obj_set_height(ui_MqttUser, 38);
@@ -113,9 +122,10 @@ void ui_ConnestScreen_screen_init(void)
     lv_obj_set_y(ui_MqttPassword, 36);
     lv_obj_set_align(ui_MqttPassword, LV_ALIGN_CENTER);
     lv_textarea_set_placeholder_text(ui_MqttPassword, "Placeholder...");
+}
 
-
-
+static void ui_ConnestScreen_step_4(void)
+{
     ui_Keyboard1 = lv_keyboard_create(ui_ConnestScreen);
     lv_obj_set_width(ui_Keyboard1, 309);
     lv_obj_set_height(ui_Keyboard1, 120);
@@ -132,5 +142,21 @@ void ui_ConnestScreen_screen_init(void)
     lv_obj_add_event_cb(ui_MqttPassword, ui_event_MqttPassword, LV_EVENT_ALL, NULL);
     lv_keyboard_set_textarea(ui_Keyboard1, ui_MqttServerUrl);
     lv_obj_add_event_cb(ui_ConnestScreen, ui_event_ConnestScreen, LV_EVENT_ALL, NULL);
+}
+
+// 分步创建：界面缓存在后台预创建时每次定时器只执行预算内的几步（见ui_screen_cache.h）
+static const ui_screen_step_t ui_ConnestScreen_step_fns[] = {
+    ui_ConnestScreen_step_0,
+    ui_ConnestScreen_step_1,
+    ui_ConnestScreen_step_2,
+    ui_ConnestScreen_step_3,
+    ui_ConnestScreen_step_4,
+};
+const ui_screen_steps_t ui_ConnestScreen_steps = UI_SCREEN_STEPS(ui_ConnestScreen_step_fns);
 
+void ui_ConnestScreen_screen_init(void)
+{
+    for(size_t i = 0; i < ui_ConnestScreen_steps.count; i++) {
+        ui_ConnestScreen_steps.steps[i]();
+    }
 }
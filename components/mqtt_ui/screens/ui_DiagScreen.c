@@ -0,0 +1,39 @@
+// 诊断界面：手工维护，不在SquareLine工程中，重新导出界面时不会生成或覆盖此文件
+// 写法与生成的界面文件保持一致，变量和事件声明在ui_app.h中
+
+#include "../ui_app.h"
+
+void ui_DiagScreen_screen_init(void)
+{
+    ui_DiagScreen = lv_obj_create(NULL);
+    lv_obj_clear_flag(ui_DiagScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+
+    ui_DiagText = lv_label_create(ui_DiagScreen);
+    lv_obj_set_width(ui_DiagText, 312);
+    lv_obj_set_height(ui_DiagText, 190);
+    lv_obj_set_x(ui_DiagText, 0);
+    lv_obj_set_y(ui_DiagText, 20);
+    lv_obj_set_align(ui_DiagText, LV_ALIGN_CENTER);
+    lv_label_set_long_mode(ui_DiagText, LV_LABEL_LONG_CLIP);
+    lv_label_set_text(ui_DiagText, "");
+    ui_style_add(ui_DiagText, UI_STYLE_LABEL_SMALL);
+
+    ui_DiagDump = lv_btn_create(ui_DiagScreen);
+    lv_obj_set_width(ui_DiagDump, 78);
+    lv_obj_set_height(ui_DiagDump, 30);
+    lv_obj_set_x(ui_DiagDump, 113);
+    lv_obj_set_y(ui_DiagDump, -100);
+    lv_obj_set_align(ui_DiagDump, LV_ALIGN_CENTER);
+    lv_obj_add_flag(ui_DiagDump, LV_OBJ_FLAG_SCROLL_ON_FOCUS);     /// Flags
+    lv_obj_clear_flag(ui_DiagDump, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
+
+    ui_Label26 = lv_label_create(ui_DiagDump);
+    lv_obj_set_width(ui_Label26, LV_SIZE_CONTENT);   /// 1
+    lv_obj_set_height(ui_Label26, LV_SIZE_CONTENT);    /// 1
+    lv_obj_set_align(ui_Label26, LV_ALIGN_CENTER);
+    lv_label_set_text(ui_Label26, "Dump");
+
+    lv_obj_add_event_cb(ui_DiagDump, ui_event_DiagDump, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_DiagScreen, ui_event_DiagScreen, LV_EVENT_ALL, NULL);
+
+}
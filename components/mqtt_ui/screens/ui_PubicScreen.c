@@ -2,10 +2,12 @@
 // SquareLine Studio version: SquareLine Studio 1.5.0
 // LVGL version: 8.3.11
 // Project name: MqttTest
+// 创建函数按控件拆成几步（ui_PubicScreen_steps，在ui_app.c中登记到界面缓存），重新导出后需要同样拆分，否则链接失败
 
 #include "../ui.h"
+#include "../ui_screen_cache.h"
 
-void ui_PubicScreen_screen_init(void)
+static void ui_PubicScreen_step_0(void)
 {
     ui_PubicScreen = lv_obj_create(NULL);
     lv_obj_clear_flag(ui_PubicScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
@@ -25,7 +27,10 @@ void ui_PubicScreen_screen_init(void)
     lv_obj_set_y(ui_Label12, -51);
     lv_obj_set_align(ui_Label12, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label12, "Msg:");
+}
 
+static void ui_PubicScreen_step_1(void)
+{
     ui_MqttTheme = lv_textarea_create(ui_PubicScreen);
     lv_obj_set_width(ui_MqttTheme, 223);
     lv_obj_set_height(ui_MqttTheme, 39);
@@ -43,9 +48,10 @@ void ui_PubicScreen_screen_init(void)
     lv_obj_set_y(ui_MqttPublicMsg, -3);
     lv_obj_set_align(ui_MqttPublicMsg, LV_ALIGN_CENTER);
     lv_textarea_set_placeholder_text(ui_MqttPublicMsg, "Placeholder...");
+}
 
-
-
+static void ui_PubicScreen_step_2(void)
+{
     ui_Label13 = lv_label_create(ui_PubicScreen);
     lv_obj_set_width(ui_Label13, LV_SIZE_CONTENT);   /// 1
     lv_obj_set_height(ui_Label13, LV_SIZE_CONTENT);    /// 1
@@ -79,7 +85,10 @@ void ui_PubicScreen_screen_init(void)
     lv_obj_set_height(ui_Label23, LV_SIZE_CONTENT);    /// 1
     lv_obj_set_align(ui_Label23, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label23, "Public");
+}
 
+static void ui_PubicScreen_step_3(void)
+{
     ui_Keyboard2 = lv_keyboard_create(ui_PubicScreen);
     lv_obj_set_width(ui_Keyboard2, 314);
     lv_obj_set_height(ui_Keyboard2, 120);
@@ -93,5 +102,20 @@ void ui_PubicScreen_screen_init(void)
     lv_obj_add_event_cb(ui_MqttQos, ui_event_MqttQos, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_MqttPublic, ui_event_MqttPublic, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_PubicScreen, ui_event_PubicScreen, LV_EVENT_ALL, NULL);
+}
 
+// 分步创建：界面缓存在后台预创建时每次定时器只执行预算内的几步（见ui_screen_cache.h）
+static const ui_screen_step_t ui_PubicScreen_step_fns[] = {
+    ui_PubicScreen_step_0,
+    ui_PubicScreen_step_1,
+    ui_PubicScreen_step_2,
+    ui_PubicScreen_step_3,
+};
+const ui_screen_steps_t ui_PubicScreen_steps = UI_SCREEN_STEPS(ui_PubicScreen_step_fns);
+
+void ui_PubicScreen_screen_init(void)
+{
+    for(size_t i = 0; i < ui_PubicScreen_steps.count; i++) {
+        ui_PubicScreen_steps.steps[i]();
+    }
 }
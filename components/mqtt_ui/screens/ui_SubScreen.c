@@ -2,10 +2,12 @@
 // SquareLine Studio version: SquareLine Studio 1.5.0
 // LVGL version: 8.3.11
 // Project name: MqttTest
+// 创建函数按控件拆成几步（ui_SubScreen_steps，在ui_app.c中登记到界面缓存），重新导出后需要同样拆分，否则链接失败
 
 #include "../ui.h"
+#include "../ui_screen_cache.h"
 
-void ui_SubScreen_screen_init(void)
+static void ui_SubScreen_step_0(void)
 {
     ui_SubScreen = lv_obj_create(NULL);
     lv_obj_clear_flag(ui_SubScreen, LV_OBJ_FLAG_SCROLLABLE);      /// Flags
@@ -25,9 +27,10 @@ void ui_SubScreen_screen_init(void)
     lv_obj_set_y(ui_SubscribeTheme, -90);
     lv_obj_set_align(ui_SubscribeTheme, LV_ALIGN_CENTER);
     lv_textarea_set_placeholder_text(ui_SubscribeTheme, "Placeholder...");
+}
 
-
-
+static void ui_SubScreen_step_1(void)
+{
     ui_MqttSubBtn = lv_btn_create(ui_SubScreen);
     lv_obj_set_width(ui_MqttSubBtn, 78);
     lv_obj_set_height(ui_MqttSubBtn, 39);
@@ -50,7 +53,10 @@ void ui_SubScreen_screen_init(void)
     lv_obj_set_y(ui_Label16, -47);
     lv_obj_set_align(ui_Label16, LV_ALIGN_CENTER);
     lv_label_set_text(ui_Label16, "Subscription list:");
+}
 
+static void ui_SubScreen_step_2(void)
+{
     ui_Keyboard3 = lv_keyboard_create(ui_SubScreen);
     lv_obj_set_width(ui_Keyboard3, 314);
     lv_obj_set_height(ui_Keyboard3, 120);
@@ -62,5 +68,19 @@ void ui_SubScreen_screen_init(void)
     lv_obj_add_event_cb(ui_SubscribeTheme, ui_event_SubscribeTheme, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_MqttSubBtn, ui_event_MqttSubBtn, LV_EVENT_ALL, NULL);
     lv_obj_add_event_cb(ui_SubScreen, ui_event_SubScreen, LV_EVENT_ALL, NULL);
+}
+
+// 分步创建：界面缓存在后台预创建时每次定时器只执行预算内的几步（见ui_screen_cache.h）
+static const ui_screen_step_t ui_SubScreen_step_fns[] = {
+    ui_SubScreen_step_0,
+    ui_SubScreen_step_1,
+    ui_SubScreen_step_2,
+};
+const ui_screen_steps_t ui_SubScreen_steps = UI_SCREEN_STEPS(ui_SubScreen_step_fns);
 
+void ui_SubScreen_screen_init(void)
+{
+    for(size_t i = 0; i < ui_SubScreen_steps.count; i++) {
+        ui_SubScreen_steps.steps[i]();
+    }
 }
@@ -0,0 +1,172 @@
+#include "ui_app.h"
+#include "ui_mem_profile.h"
+
+// SCREEN: ui_homeScreen
+lv_obj_t * ui_MsgFilter;
+lv_obj_t * ui_Keyboard4;
+
+// SCREEN: ui_ChartScreen
+lv_obj_t * ui_ChartScreen;
+lv_obj_t * ui_ChartTopic;
+lv_obj_t * ui_ChartField;
+lv_obj_t * ui_ChartMode;
+lv_obj_t * ui_TopicChart;
+lv_obj_t * ui_ChartStats;
+
+// SCREEN: ui_DiagScreen
+lv_obj_t * ui_DiagScreen;
+lv_obj_t * ui_DiagText;
+lv_obj_t * ui_DiagDump;
+lv_obj_t * ui_Label26;
+
+static lv_obj_t * s_keyboard = NULL;   ///< 共用键盘
+
+lv_obj_t * ui_keyboard_shared(void) {
+    if (s_keyboard == NULL) {
+        s_keyboard = lv_keyboard_create(lv_layer_top());
+        lv_obj_set_width(s_keyboard, 314);
+        lv_obj_set_height(s_keyboard, 120);
+        lv_obj_set_x(s_keyboard, 0);
+        lv_obj_set_y(s_keyboard, 56);
+        lv_obj_set_align(s_keyboard, LV_ALIGN_CENTER);
+        lv_obj_add_flag(s_keyboard, LV_OBJ_FLAG_HIDDEN);
+    }
+    return s_keyboard;
+}
+
+void ui_keyboard_park(void) {
+    if (s_keyboard == NULL) {
+        return;
+    }
+    // 先解除输入框，输入框所在的界面之后可能被删除
+    lv_keyboard_set_textarea(s_keyboard, NULL);
+    lv_obj_add_flag(s_keyboard, LV_OBJ_FLAG_HIDDEN);
+}
+
+/**
+ * @brief 生成代码中所有的_ui_screen_change调用都链接到这里（-Wl,--wrap=_ui_screen_change）
+ * @note 界面在第一次进入时创建，超出内存预算时按最久未使用的顺序删除
+ */
+void __wrap__ui_screen_change(lv_obj_t ** target, lv_scr_load_anim_t fademode, int spd, int delay,
+                              void (*target_init)(void));
+void __wrap__ui_screen_change(lv_obj_t ** target, lv_scr_load_anim_t fademode, int spd, int delay,
+                              void (*target_init)(void)) {
+    ui_keyboard_park();
+    ui_screen_cache_load(target, target_init, fademode, spd, delay);
+}
+
+void ui_event_homeScreen(lv_event_t * e) {
+    lv_event_code_t event_code = lv_event_get_code(e);
+
+    if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_LEFT) {
+        lv_indev_wait_release(lv_indev_get_act());
+        _ui_screen_change(&ui_ChartScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, &ui_ChartScreen_screen_init);
+    }
+}
+
+void ui_event_MsgFilter(lv_event_t * e) {
+    lv_event_code_t event_code = lv_event_get_code(e);
+
+    if (event_code == LV_EVENT_CLICKED) {
+        _ui_keyboard_set_target(ui_Keyboard4, ui_MsgFilter);
+        _ui_flag_modify(ui_Keyboard4, LV_OBJ_FLAG_HIDDEN, _UI_MODIFY_FLAG_TOGGLE);
+    }
+    if (event_code == LV_EVENT_VALUE_CHANGED) {
+        on_msg_filter_changed(e);
+    }
+}
+
+void ui_event_ChartScreen(lv_event_t * e) {
+    lv_event_code_t event_code = lv_event_get_code(e);
+
+    if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_RIGHT) {
+        lv_indev_wait_release(lv_indev_get_act());
+        _ui_screen_change(&ui_homeScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, &ui_homeScreen_screen_init);
+    }
+    if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_LEFT) {
+        lv_indev_wait_release(lv_indev_get_act());
+        _ui_screen_change(&ui_DiagScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, &ui_DiagScreen_screen_init);
+    }
+    if (event_code == LV_EVENT_SCREEN_LOADED) {
+        on_chart_screen_loaded(e);
+    }
+}
+
+void ui_event_DiagScreen(lv_event_t * e) {
+    lv_event_code_t event_code = lv_event_get_code(e);
+
+    if (event_code == LV_EVENT_GESTURE && lv_indev_get_gesture_dir(lv_indev_get_act()) == LV_DIR_RIGHT) {
+        lv_indev_wait_release(lv_indev_get_act());
+        _ui_screen_change(&ui_ChartScreen, LV_SCR_LOAD_ANIM_FADE_ON, 500, 0, &ui_ChartScreen_screen_init);
+    }
+    if (event_code == LV_EVENT_SCREEN_LOADED) {
+        on_diag_screen_loaded(e);
+    }
+    if (event_code == LV_EVENT_SCREEN_UNLOAD_START) {
+        on_diag_screen_unloaded(e);
+    }
+}
+
+void ui_event_DiagDump(lv_event_t * e) {
+    if (lv_event_get_code(e) == LV_EVENT_CLICKED) {
+        on_diag_dump(e);
+    }
+}
+
+// 主界面：生成的界面加上消息过滤框，消息区相应缩短
+static void home_screen_init(void) {
+    ui_homeScreen_screen_init();
+
+    ui_MsgFilter = lv_textarea_create(ui_homeScreen);
+    lv_obj_set_width(ui_MsgFilter, 312);
+    lv_obj_set_height(ui_MsgFilter, 32);
+    lv_obj_set_x(ui_MsgFilter, -2);
+    lv_obj_set_y(ui_MsgFilter, -51);
+    lv_obj_set_align(ui_MsgFilter, LV_ALIGN_CENTER);
+    lv_textarea_set_one_line(ui_MsgFilter, true);
+    lv_textarea_set_placeholder_text(ui_MsgFilter, "Filter: topic/+ text");
+
+    lv_obj_set_height(ui_reviceMsg, 117);
+    lv_obj_set_y(ui_reviceMsg, 25);
+    ui_style_add(ui_reviceMsg, UI_STYLE_TEXTAREA_LOG);
+
+    ui_Keyboard4 = ui_keyboard_shared();
+
+    lv_obj_add_event_cb(ui_MsgFilter, ui_event_MsgFilter, LV_EVENT_ALL, NULL);
+    lv_obj_add_event_cb(ui_homeScreen, ui_event_homeScreen, LV_EVENT_ALL, NULL);
+}
+
+void ui_app_init(void) {
+    lv_disp_t * dispp = lv_disp_get_default();
+    lv_theme_t * theme = lv_theme_default_init(dispp, lv_palette_main(LV_PALETTE_BLUE), lv_palette_main(LV_PALETTE_RED),
+                                               false, LV_FONT_DEFAULT);
+    lv_disp_set_theme(dispp, theme);
+    ui_styles_init();
+
+    ui_mem_profile_build_begin("home");
+    home_screen_init();
+    ui_mem_profile_build_end("home", ui_homeScreen);
+
+    ui_screen_cache_register(&ui_homeScreen, home_screen_init, "home", true, NULL, NULL);
+    ui_screen_cache_register(&ui_ConnestScreen, ui_ConnestScreen_screen_init, "connect", false,
+                             on_connect_screen_built, on_connect_screen_evicted);
+    ui_screen_cache_register(&ui_PubicScreen, ui_PubicScreen_screen_init, "publish", false,
+                             on_publish_screen_built, NULL);
+    ui_screen_cache_register(&ui_SubScreen, ui_SubScreen_screen_init, "subscribe", false,
+                             on_subscribe_screen_built, NULL);
+    ui_screen_cache_register(&ui_ChartScreen, ui_ChartScreen_screen_init, "chart", false, NULL,
+                             on_chart_screen_evicted);
+    ui_screen_cache_register(&ui_DiagScreen, ui_DiagScreen_screen_init, "diag", false, NULL, NULL);
+    ui_screen_cache_set_steps(&ui_ConnestScreen, &ui_ConnestScreen_steps);
+    ui_screen_cache_set_steps(&ui_PubicScreen, &ui_PubicScreen_steps);
+    ui_screen_cache_set_steps(&ui_SubScreen, &ui_SubScreen_steps);
+    ui_screen_cache_set_steps(&ui_ChartScreen, &ui_ChartScreen_steps);
+    ui____initial_actions0 = lv_obj_create(NULL);
+    lv_disp_load_scr(ui_homeScreen);
+
+    // 主界面显示后再在后台分片创建其他界面
+    ui_screen_cache_prebuild(&ui_ConnestScreen);
+    ui_screen_cache_prebuild(&ui_ChartScreen);
+    ui_screen_cache_prebuild(&ui_PubicScreen);
+    ui_screen_cache_prebuild(&ui_SubScreen);
+}
@@ -0,0 +1,73 @@
+#ifndef _UI_APP_H
+#define _UI_APP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "ui.h"
+#include "ui_screen_cache.h"
+#include "ui_styles.h"
+
+/**
+ * @brief 手工维护的界面部分
+ *
+ * ui.c、ui.h、ui_helpers.c和screens下的SquareLine界面文件由SquareLine导出时覆盖，
+ * 不在SquareLine工程中的界面、追加到生成界面上的控件、界面缓存的接入都放在这里。
+ * 生成代码中的_ui_screen_change在链接时替换为本文件的实现（见CMakeLists.txt中的--wrap）。
+ */
+
+// 生成的界面文件中的分步创建函数表（后台预创建时分片执行）
+extern const ui_screen_steps_t ui_ConnestScreen_steps;
+extern const ui_screen_steps_t ui_PubicScreen_steps;
+extern const ui_screen_steps_t ui_SubScreen_steps;
+
+// SCREEN: ui_homeScreen（在生成的界面上追加的控件）
+void ui_event_homeScreen(lv_event_t * e);
+void ui_event_MsgFilter(lv_event_t * e);
+extern lv_obj_t * ui_MsgFilter;
+extern lv_obj_t * ui_Keyboard4;
+
+// SCREEN: ui_ChartScreen（screens/ui_ChartScreen.c）
+void ui_ChartScreen_screen_init(void);
+void ui_event_ChartScreen(lv_event_t * e);
+extern lv_obj_t * ui_ChartScreen;
+extern lv_obj_t * ui_ChartTopic;
+extern lv_obj_t * ui_ChartField;
+extern lv_obj_t * ui_ChartMode;
+extern lv_obj_t * ui_TopicChart;
+extern lv_obj_t * ui_ChartStats;
+extern const ui_screen_steps_t ui_ChartScreen_steps;
+
+// SCREEN: ui_DiagScreen（screens/ui_DiagScreen.c）
+void ui_DiagScreen_screen_init(void);
+void ui_event_DiagScreen(lv_event_t * e);
+extern lv_obj_t * ui_DiagScreen;
+extern lv_obj_t * ui_DiagText;
+void ui_event_DiagDump(lv_event_t * e);
+extern lv_obj_t * ui_DiagDump;
+extern lv_obj_t * ui_Label26;
+
+/**
+ * @brief 所有界面共用的键盘（第一次调用时创建，放在顶层）
+ * @note 界面创建后ui_Keyboard1~4改为指向它（见ui_events.c）
+ */
+lv_obj_t * ui_keyboard_shared(void);
+
+/**
+ * @brief 隐藏共用键盘并解除输入框（切换界面前调用）
+ */
+void ui_keyboard_park(void);
+
+/**
+ * @brief 初始化UI，代替生成的ui_init（ui_init会一次创建所有界面）
+ * @note 只创建主界面，其他界面登记到界面缓存，在后台分片创建或第一次进入时创建。
+ *       调用时需要持有LVGL锁
+ */
+void ui_app_init(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
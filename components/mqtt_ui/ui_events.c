@@ -4,12 +4,27 @@
 // Project name: MqttTest
 
 #include <stdio.h>
+#include "esp_log.h"
 #include "task_communication.h"
-#include "ui.h"
+#include "ui_app.h"
 #include "ui_interface.h"
 #include "mqtt_message_display.h"
+#include "mqtt_chart_display.h"
+#include "ui_mem_profile.h"
+#include "ui_screen_cache.h"
+
+static const char *TAG = "UI_EVENTS";
 
 static uint8_t rest;
+static bool mqtt_connected = false;          // 连接界面删除后按此状态恢复按钮
+static lv_obj_t* bound_chart = NULL;
+
+// 连接界面删除时保存输入框内容，重新创建时恢复
+#define CONNECT_FORM_TEXT_LEN 128
+static lv_obj_t** const connect_form[] = {&ui_MqttServerUrl, &ui_MqttServerPort, &ui_MqttUser,
+                                          &ui_MqttPassword};
+static char connect_form_text[4][CONNECT_FORM_TEXT_LEN];
+static bool connect_form_saved = false;
 
 void on_clean_ricv_msg(lv_event_t* e) {
    lv_event_code_t event_code = lv_event_get_code(e);
@@ -20,6 +35,123 @@ void on_clean_ricv_msg(lv_event_t* e) {
     }
 }
 
+void on_msg_filter_changed(lv_event_t* e) {
+  // 每次输入变化都重新过滤，查询走增量索引，开销很小
+  mqtt_display_set_filter_expr(lv_textarea_get_text(ui_MsgFilter));
+}
+
+void on_chart_screen_loaded(lv_event_t* e) {
+  // 图表界面重建后需要重新绑定，否则只刷新主题列表
+  if (bound_chart != ui_TopicChart) {
+    mqtt_chart_unbind();
+    mqtt_chart_bind(ui_TopicChart, ui_ChartTopic, ui_ChartField, ui_ChartMode, ui_ChartStats);
+    bound_chart = ui_TopicChart;
+  } else {
+    mqtt_chart_refresh_topics();
+  }
+}
+
+// 诊断界面显示期间定时刷新内存统计
+#define DIAG_REFRESH_MS 1000
+static lv_timer_t* diag_timer = NULL;
+
+static void diag_refresh(lv_timer_t* timer) {
+  static char text[768];
+  ui_mem_profile_format(text, sizeof(text));
+  lv_label_set_text(ui_DiagText, text);
+}
+
+void on_diag_screen_loaded(lv_event_t* e) {
+  if (diag_timer == NULL) {
+    diag_timer = lv_timer_create(diag_refresh, DIAG_REFRESH_MS, NULL);
+  }
+  diag_refresh(diag_timer);
+}
+
+void on_diag_screen_unloaded(lv_event_t* e) {
+  if (diag_timer != NULL) {
+    lv_timer_del(diag_timer);
+    diag_timer = NULL;
+  }
+}
+
+void on_diag_dump(lv_event_t* e) {
+  ui_screen_stats_t stats[UI_CACHE_MAX_SCREENS];
+  size_t n = ui_screen_cache_get_stats(stats, UI_CACHE_MAX_SCREENS);
+
+  ui_mem_profile_dump();
+  for (size_t i = 0; i < n; i++) {
+    ESP_LOGI(TAG, "%-9s %s builds %u hits %u build %lu us hit %lu us", stats[i].name,
+             stats[i].resident ? "resident" : "evicted ", stats[i].builds, stats[i].hits,
+             (unsigned long)stats[i].build_us, (unsigned long)stats[i].hit_us);
+  }
+}
+
+void on_chart_screen_evicted(void) {
+  // 图表控件即将删除，解除绑定（新控件可能复用同一地址，也要清除记录）
+  mqtt_chart_unbind();
+  bound_chart = NULL;
+}
+
+// SquareLine为每个界面生成了一个键盘，创建后换成共用键盘（生成的代码保持不变）
+static void keyboard_adopt(lv_obj_t** keyboard) {
+  lv_obj_t* shared = ui_keyboard_shared();
+
+  if (*keyboard != shared) {
+    lv_obj_del(*keyboard);
+    *keyboard = shared;
+  }
+}
+
+void on_connect_screen_built(void) {
+  keyboard_adopt(&ui_Keyboard1);
+  if (connect_form_saved) {
+    for (size_t i = 0; i < 4; i++) {
+      lv_textarea_set_text(*connect_form[i], connect_form_text[i]);
+    }
+  }
+  ui_set_mqtt_connected(mqtt_connected);
+}
+
+void on_publish_screen_built(void) {
+  keyboard_adopt(&ui_Keyboard2);
+}
+
+void on_subscribe_screen_built(void) {
+  keyboard_adopt(&ui_Keyboard3);
+}
+
+void on_connect_screen_evicted(void) {
+  for (size_t i = 0; i < 4; i++) {
+    snprintf(connect_form_text[i], CONNECT_FORM_TEXT_LEN, "%s", lv_textarea_get_text(*connect_form[i]));
+  }
+  connect_form_saved = true;
+}
+
+void ui_set_mqtt_connected(bool connected) {
+  mqtt_connected = connected;
+  if (ui_ConnestScreen == NULL) {
+    return;  // 连接界面未创建，创建时再应用
+  }
+  if (connected) {
+    // Connect按钮变绿色并禁用
+    ui_style_set_btn(ui_MqttConnect, UI_STYLE_BTN_ON);
+    lv_obj_add_state(ui_MqttConnect, LV_STATE_DISABLED);
+
+    // Disconnect按钮变红并启用
+    ui_style_set_btn(ui_MqttDisconnect, UI_STYLE_BTN_DANGER);
+    lv_obj_clear_state(ui_MqttDisconnect, LV_STATE_DISABLED);
+  } else {
+    // Disconnect按钮变蓝并禁用
+    ui_style_set_btn(ui_MqttDisconnect, UI_STYLE_BTN_IDLE);
+    lv_obj_add_state(ui_MqttDisconnect, LV_STATE_DISABLED);
+
+    // Connect按钮变蓝并启用
+    ui_style_set_btn(ui_MqttConnect, UI_STYLE_BTN_IDLE);
+    lv_obj_clear_state(ui_MqttConnect, LV_STATE_DISABLED);
+  }
+}
+
 void mqtt_server_connect(lv_event_t* e) {
   
   printf("Connecting to MQTT server\n");
@@ -61,16 +193,7 @@ void mqtt_server_connect(lv_event_t* e) {
 }
 
 void mqtt_server_disconnect(lv_event_t* e) {
-  // Disconnect按钮变蓝并禁用
-  lv_obj_set_style_bg_color(ui_MqttDisconnect, lv_color_hex(0x2196F3),
-                            LV_PART_MAIN);
-  lv_obj_add_state(ui_MqttDisconnect, LV_STATE_DISABLED);
-
-  // Connect按钮变蓝并启用
-  lv_obj_set_style_bg_color(ui_MqttConnect, lv_color_hex(0x2196F3),
-                            LV_PART_MAIN);
-  lv_obj_clear_state(ui_MqttConnect, LV_STATE_DISABLED);
-
+  ui_set_mqtt_connected(false);
   lv_label_set_text(ui_MqttState, "Disconnected");
   mqtt_display_add_system_msg("Disconnected from MQTT server", "INFO");
 }
@@ -11,6 +11,11 @@ extern "C" {
 #endif
 
 void on_clean_ricv_msg(lv_event_t * e);
+void on_msg_filter_changed(lv_event_t * e);
+void on_chart_screen_loaded(lv_event_t * e);
+void on_diag_screen_loaded(lv_event_t * e);
+void on_diag_screen_unloaded(lv_event_t * e);
+void on_diag_dump(lv_event_t * e);
 void mqtt_server_connect(lv_event_t * e);
 void mqtt_server_disconnect(lv_event_t * e);
 void on_clicked_server_set(lv_event_t * e);
@@ -24,6 +29,16 @@ void mqtt_publish(lv_event_t * e);
 void sub_theme_input(lv_event_t * e);
 void sub_theme_btn(lv_event_t * e);
 
+// 界面缓存回调（见ui_screen_cache.h）
+void on_connect_screen_built(void);
+void on_publish_screen_built(void);
+void on_subscribe_screen_built(void);
+void on_connect_screen_evicted(void);
+void on_chart_screen_evicted(void);
+
+// 更新连接界面的按钮状态，连接界面未创建时记录状态，创建后应用
+void ui_set_mqtt_connected(bool connected);
+
 #ifdef __cplusplus
 } /*extern "C"*/
 #endif
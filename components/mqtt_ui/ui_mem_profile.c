@@ -0,0 +1,234 @@
+#include "ui_mem_profile.h"
+#include <stdio.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char *TAG = "UI_MEM";
+
+static ui_mem_profile_t s_profiles[UI_MEM_PROFILE_MAX];
+static size_t s_count = 0;
+
+void ui_mem_snapshot(ui_mem_snapshot_t *snap) {
+    memset(snap, 0, sizeof(*snap));
+#if !LV_MEM_CUSTOM
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    snap->lv_used = mon.total_size - mon.free_size;
+    snap->lv_biggest = mon.free_biggest_size;
+    snap->lv_frag_pct = mon.frag_pct;
+#endif
+    snap->int_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snap->int_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snap->int_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    snap->ext_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    snap->ext_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+}
+
+#if UI_MEM_PROFILE_ENABLE
+
+/**
+ * @brief 正在创建/删除的界面的开始状态，分步创建时累计暂停之前各段的占用
+ */
+typedef struct {
+    ui_mem_snapshot_t before;
+    int32_t lv_bytes;
+    int32_t int_bytes;
+    int32_t ext_bytes;
+} mem_pending_t;
+
+static mem_pending_t s_pending[UI_MEM_PROFILE_MAX];
+
+static ui_mem_profile_t *find_profile(const char *name) {
+    for (size_t i = 0; i < s_count; i++) {
+        if (strcmp(s_profiles[i].name, name) == 0) {
+            return &s_profiles[i];
+        }
+    }
+    if (s_count >= UI_MEM_PROFILE_MAX) {
+        return NULL;
+    }
+    ui_mem_profile_t *p = &s_profiles[s_count++];
+    memset(p, 0, sizeof(*p));
+    p->name = name;
+    return p;
+}
+
+// 界面及其所有子对象的数量
+static uint32_t count_objs(lv_obj_t *obj) {
+    uint32_t n = 1;
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < cnt; i++) {
+        n += count_objs(lv_obj_get_child(obj, i));
+    }
+    return n;
+}
+
+static mem_pending_t *pending_of(const ui_mem_profile_t *p) {
+    return &s_pending[p - s_profiles];
+}
+
+// 从开始状态到now占用的字节数（剩余减少为正）
+static void mem_delta(const mem_pending_t *pd, const ui_mem_snapshot_t *now, int32_t *lv, int32_t *in,
+                      int32_t *ext) {
+    *lv = (int32_t)now->lv_used - (int32_t)pd->before.lv_used;
+    *in = (int32_t)pd->before.int_free - (int32_t)now->int_free;
+    *ext = (int32_t)pd->before.ext_free - (int32_t)now->ext_free;
+}
+
+void ui_mem_profile_build_begin(const char *name) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    mem_pending_t *pd = pending_of(p);
+    memset(pd, 0, sizeof(*pd));
+    ui_mem_snapshot(&pd->before);
+}
+
+void ui_mem_profile_build_suspend(const char *name) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    mem_pending_t *pd = pending_of(p);
+    ui_mem_snapshot_t now;
+    int32_t lv, in, ext;
+
+    ui_mem_snapshot(&now);
+    mem_delta(pd, &now, &lv, &in, &ext);
+    pd->lv_bytes += lv;
+    pd->int_bytes += in;
+    pd->ext_bytes += ext;
+}
+
+void ui_mem_profile_build_resume(const char *name) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    ui_mem_snapshot(&pending_of(p)->before);
+}
+
+void ui_mem_profile_build_end(const char *name, lv_obj_t *screen) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    mem_pending_t *pd = pending_of(p);
+    ui_mem_snapshot(&p->after);
+    mem_delta(pd, &p->after, &p->lv_bytes, &p->int_bytes, &p->ext_bytes);
+    p->lv_bytes += pd->lv_bytes;
+    p->int_bytes += pd->int_bytes;
+    p->ext_bytes += pd->ext_bytes;
+    p->objs = count_objs(screen);
+    p->builds++;
+    // LV_MEM_CUSTOM时对象分配在堆上，只按堆计算
+    p->leak_bytes += p->int_bytes + p->ext_bytes;
+#if !LV_MEM_CUSTOM
+    p->leak_bytes += p->lv_bytes;
+#endif
+
+#if UI_MEM_PROFILE_LOG
+    ESP_LOGI(TAG, "%s built: %lu objs, lv %+ld B (frag %u%%), int %+ld B (free %lu, largest %lu), ext %+ld B",
+             name, (unsigned long)p->objs, (long)p->lv_bytes, p->after.lv_frag_pct, (long)p->int_bytes,
+             (unsigned long)p->after.int_free, (unsigned long)p->after.int_largest, (long)p->ext_bytes);
+#endif
+}
+
+void ui_mem_profile_evict_begin(const char *name) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    ui_mem_snapshot(&pending_of(p)->before);
+}
+
+void ui_mem_profile_evict_end(const char *name) {
+    ui_mem_profile_t *p = find_profile(name);
+    if (p == NULL) {
+        return;
+    }
+    ui_mem_snapshot_t now;
+    int32_t lv, in, ext;
+
+    ui_mem_snapshot(&now);
+    mem_delta(pending_of(p), &now, &lv, &in, &ext);
+    p->evicts++;
+    // 删除时占用为负，累加后剩下的是没有释放的部分
+    p->leak_bytes += in + ext;
+#if !LV_MEM_CUSTOM
+    p->leak_bytes += lv;
+#endif
+
+#if UI_MEM_PROFILE_LOG
+    ESP_LOGI(TAG, "%s evicted: lv %+ld B, int %+ld B (largest %lu), ext %+ld B, unreleased %ld B after %u builds",
+             name, (long)lv, (long)in, (unsigned long)now.int_largest, (long)ext, (long)p->leak_bytes,
+             p->builds);
+#endif
+}
+
+#else
+
+void ui_mem_profile_build_begin(const char *name) {}
+void ui_mem_profile_build_suspend(const char *name) {}
+void ui_mem_profile_build_resume(const char *name) {}
+void ui_mem_profile_build_end(const char *name, lv_obj_t *screen) {}
+void ui_mem_profile_evict_begin(const char *name) {}
+void ui_mem_profile_evict_end(const char *name) {}
+
+#endif  // UI_MEM_PROFILE_ENABLE
+
+size_t ui_mem_profile_get(ui_mem_profile_t *out, size_t max) {
+    size_t n = (s_count < max) ? s_count : max;
+    memcpy(out, s_profiles, n * sizeof(*out));
+    return n;
+}
+
+size_t ui_mem_profile_format(char *buf, size_t size) {
+    ui_mem_snapshot_t now;
+    size_t len = 0;
+
+#define APPEND(...)                                                      \
+    do {                                                                 \
+        if (len < size) {                                                \
+            int r = snprintf(buf + len, size - len, __VA_ARGS__);        \
+            len += (r > 0) ? (size_t)r : 0;                              \
+        }                                                                \
+    } while (0)
+
+    if (size == 0) {
+        return 0;
+    }
+    buf[0] = '\0';
+    ui_mem_snapshot(&now);
+#if !LV_MEM_CUSTOM
+    APPEND("LV %lu B used, max blk %lu B, frag %u%%\n", (unsigned long)now.lv_used,
+           (unsigned long)now.lv_biggest, now.lv_frag_pct);
+#endif
+    APPEND("INT %lu B free, max blk %lu B, min %lu B\n", (unsigned long)now.int_free,
+           (unsigned long)now.int_largest, (unsigned long)now.int_min_free);
+    if (now.ext_free > 0) {
+        APPEND("EXT %lu B free, max blk %lu B\n", (unsigned long)now.ext_free, (unsigned long)now.ext_largest);
+    }
+    // heap为内部RAM和PSRAM合计，leak只在界面已删除时有意义
+    APPEND("screen   objs     lv   heap  leak b/e\n");
+    for (size_t i = 0; i < s_count; i++) {
+        const ui_mem_profile_t *p = &s_profiles[i];
+        char leak[12] = "-";
+        if (p->builds == p->evicts) {
+            snprintf(leak, sizeof(leak), "%ld", (long)p->leak_bytes);
+        }
+        APPEND("%-8.8s %4lu %6ld %6ld %5s %u/%u\n", p->name, (unsigned long)p->objs, (long)p->lv_bytes,
+               (long)(p->int_bytes + p->ext_bytes), leak, p->builds, p->evicts);
+    }
+#undef APPEND
+
+    return (len < size) ? len : size - 1;
+}
+
+void ui_mem_profile_dump(void) {
+    char buf[768];
+    ui_mem_profile_format(buf, sizeof(buf));
+    ESP_LOGI(TAG, "Memory profile:\n%s", buf);
+}
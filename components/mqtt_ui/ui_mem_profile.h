@@ -0,0 +1,110 @@
+#ifndef _UI_MEM_PROFILE_H
+#define _UI_MEM_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * @defgroup UI_MEM_PROFILE_CONFIG 界面内存统计配置
+ * @brief 每个界面创建前后记录LVGL内存池和堆的剩余/最大空闲块，删除时记录释放量，
+ *        创建与释放之差累计为疑似泄漏
+ * @{
+ */
+#define UI_MEM_PROFILE_ENABLE     1    ///< 为0时不统计
+#define UI_MEM_PROFILE_MAX        8    ///< 统计的界面数量上限
+#define UI_MEM_PROFILE_LOG        1    ///< 每次创建/删除界面时输出到串口
+/** @} */
+
+/**
+ * @brief 某一时刻的内存状态
+ */
+typedef struct {
+    uint32_t lv_used;          ///< LVGL内存池已用字节（LV_MEM_CUSTOM时为0）
+    uint32_t lv_biggest;       ///< LVGL内存池最大空闲块
+    uint8_t lv_frag_pct;       ///< LVGL内存池碎片率（%）
+    uint32_t int_free;         ///< 内部RAM剩余
+    uint32_t int_largest;      ///< 内部RAM最大空闲块
+    uint32_t int_min_free;     ///< 启动以来内部RAM最少剩余
+    uint32_t ext_free;         ///< PSRAM剩余（没有PSRAM时为0）
+    uint32_t ext_largest;      ///< PSRAM最大空闲块
+} ui_mem_snapshot_t;
+
+/**
+ * @brief 单个界面的内存统计
+ */
+typedef struct {
+    const char *name;
+    uint16_t builds;           ///< 创建次数
+    uint16_t evicts;           ///< 删除次数
+    uint32_t objs;             ///< 最近一次创建的对象数（含界面本身）
+    int32_t lv_bytes;          ///< 最近一次创建占用的LVGL内存池
+    int32_t int_bytes;         ///< 最近一次创建占用的内部RAM
+    int32_t ext_bytes;         ///< 最近一次创建占用的PSRAM
+    int32_t leak_bytes;        ///< 累计的（创建占用 - 删除释放），界面已删除时不为0且持续增长说明切换路径有泄漏
+    ui_mem_snapshot_t after;   ///< 最近一次创建后的内存状态
+} ui_mem_profile_t;
+
+/**
+ * @brief 读取当前内存状态
+ */
+void ui_mem_snapshot(ui_mem_snapshot_t *snap);
+
+/**
+ * @brief 界面创建前调用
+ */
+void ui_mem_profile_build_begin(const char *name);
+
+/**
+ * @brief 分步创建时在两段之间暂停统计，暂停期间其他模块的分配不计入该界面
+ */
+void ui_mem_profile_build_suspend(const char *name);
+
+/**
+ * @brief 分步创建继续时调用
+ */
+void ui_mem_profile_build_resume(const char *name);
+
+/**
+ * @brief 界面创建后调用，统计对象数和内存占用
+ * @param screen 刚创建的界面
+ */
+void ui_mem_profile_build_end(const char *name, lv_obj_t *screen);
+
+/**
+ * @brief 界面删除前调用
+ */
+void ui_mem_profile_evict_begin(const char *name);
+
+/**
+ * @brief 界面删除后调用，统计释放量
+ */
+void ui_mem_profile_evict_end(const char *name);
+
+/**
+ * @brief 获取各界面的统计
+ * @return 写入的条数
+ */
+size_t ui_mem_profile_get(ui_mem_profile_t *out, size_t max);
+
+/**
+ * @brief 把当前内存状态和各界面的统计格式化为文本（诊断界面和串口共用）
+ * @return 写入的字符数（不含结尾的0）
+ */
+size_t ui_mem_profile_format(char *buf, size_t size);
+
+/**
+ * @brief 把统计输出到串口
+ */
+void ui_mem_profile_dump(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
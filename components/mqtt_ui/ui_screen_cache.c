@@ -0,0 +1,343 @@
+#include "ui_screen_cache.h"
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "pm_budget.h"
+#include "ui_mem_profile.h"
+
+static const char *TAG = "UI_CACHE";
+
+typedef struct {
+    lv_obj_t **screen;
+    void (*init)(void);
+    const ui_screen_steps_t *steps;  ///< 分步创建函数表，NULL时init作为一步
+    ui_screen_hook_t on_build;
+    ui_screen_hook_t on_evict;
+    bool pinned;
+    bool prebuild;           ///< 等待后台预创建
+    uint32_t last_use;       ///< 最近一次加载的序号（越小越久未使用）
+    size_t next_step;        ///< 下一个要执行的创建步骤，0表示未开始
+    uint32_t step_us;        ///< 本次创建已用的时间（不含步骤之间的等待）
+    int32_t step_mem;        ///< 本次创建已占用的内存
+    ui_screen_stats_t stats;
+    uint64_t build_us_sum;
+    uint64_t hit_us_sum;
+} cache_entry_t;
+
+static cache_entry_t s_entries[UI_CACHE_MAX_SCREENS];
+static size_t s_count = 0;
+static uint32_t s_use_seq = 0;
+static lv_timer_t *s_prebuild_timer = NULL;
+static cache_entry_t *s_building = NULL;  ///< 后台预创建到一半的界面
+
+static cache_entry_t *find_entry(lv_obj_t **screen) {
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_entries[i].screen == screen) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static cache_entry_t *add_entry(lv_obj_t **screen, void (*init)(void), const char *name) {
+    if (s_count >= UI_CACHE_MAX_SCREENS) {
+        ESP_LOGW(TAG, "Too many screens, increase UI_CACHE_MAX_SCREENS");
+        return NULL;
+    }
+    cache_entry_t *e = &s_entries[s_count++];
+    memset(e, 0, sizeof(*e));
+    e->screen = screen;
+    e->init = init;
+    e->stats.name = name ? name : "screen";
+    return e;
+}
+
+// 界面占用的内存：LVGL内存池的已用字节，LV_MEM_CUSTOM时按堆的已用字节
+static size_t mem_used(void) {
+#if !LV_MEM_CUSTOM
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+#else
+    return heap_caps_get_total_size(MALLOC_CAP_8BIT) - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+#endif
+}
+
+static bool over_budget(void) {
+#if !LV_MEM_CUSTOM
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (mon.used_pct > UI_CACHE_LV_MEM_MAX_PCT) {
+        return true;
+    }
+#endif
+    return heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < UI_CACHE_HEAP_MIN_FREE;
+}
+
+// 当前显示、正在切入或切出的界面不能删除
+static bool in_use(lv_obj_t *scr) {
+    lv_disp_t *disp = lv_disp_get_default();
+    return scr == lv_scr_act() || scr == disp->prev_scr || scr == disp->scr_to_load;
+}
+
+static void evict(cache_entry_t *e) {
+    size_t before = mem_used();
+
+    ui_mem_profile_evict_begin(e->stats.name);
+    if (e->on_evict) {
+        e->on_evict();
+    }
+    lv_obj_del(*e->screen);
+    *e->screen = NULL;
+    ui_mem_profile_evict_end(e->stats.name);
+    e->stats.resident = false;
+    ESP_LOGI(TAG, "%s evicted (-%u B)", e->stats.name, (unsigned)(before - mem_used()));
+}
+
+void ui_screen_cache_trim(void) {
+    while (over_budget()) {
+        cache_entry_t *lru = NULL;
+        for (size_t i = 0; i < s_count; i++) {
+            cache_entry_t *e = &s_entries[i];
+            if (e->pinned || *e->screen == NULL || e == s_building || in_use(*e->screen)) {
+                continue;
+            }
+            if (lru == NULL || e->last_use < lru->last_use) {
+                lru = e;
+            }
+        }
+        if (lru == NULL) {
+            return;  // 没有可删除的界面
+        }
+        evict(lru);
+    }
+}
+
+static void trim_async_cb(void *arg) {
+    ui_screen_cache_trim();
+}
+
+// 切换动画结束后旧界面才可以删除，在事件回调之外执行
+static void screen_unloaded_cb(lv_event_t *e) {
+    lv_async_call(trim_async_cb, NULL);
+}
+
+void ui_screen_cache_register(lv_obj_t **screen, void (*init)(void), const char *name, bool pinned,
+                              ui_screen_hook_t on_build, ui_screen_hook_t on_evict) {
+    cache_entry_t *e = find_entry(screen);
+
+    if (e == NULL && (e = add_entry(screen, init, name)) == NULL) {
+        return;
+    }
+    e->pinned = pinned;
+    e->on_build = on_build;
+    e->on_evict = on_evict;
+    if (*screen != NULL && !e->stats.resident) {
+        e->stats.resident = true;
+        lv_obj_add_event_cb(*screen, screen_unloaded_cb, LV_EVENT_SCREEN_UNLOADED, NULL);
+    }
+}
+
+void ui_screen_cache_set_steps(lv_obj_t **screen, const ui_screen_steps_t *steps) {
+    cache_entry_t *e = find_entry(screen);
+
+    if (e != NULL && e->next_step == 0) {
+        e->steps = steps;
+    }
+}
+
+static size_t step_count(const cache_entry_t *e) {
+    return e->steps != NULL ? e->steps->count : 1;
+}
+
+// 所有步骤完成后：登记删除回调、调用创建回调并更新统计
+static void finish_build(cache_entry_t *e) {
+    int64_t t0 = esp_timer_get_time();
+    size_t before = mem_used();
+
+    lv_obj_add_event_cb(*e->screen, screen_unloaded_cb, LV_EVENT_SCREEN_UNLOADED, NULL);
+    if (e->on_build) {
+        e->on_build();
+    }
+    ui_mem_profile_build_end(e->stats.name, *e->screen);
+
+    e->step_us += (uint32_t)(esp_timer_get_time() - t0);
+    e->step_mem += (int32_t)mem_used() - (int32_t)before;
+    e->next_step = 0;
+    if (s_building == e) {
+        s_building = NULL;
+    }
+    e->stats.resident = true;
+    e->stats.builds++;
+    e->stats.mem_bytes = (e->step_mem > 0) ? e->step_mem : 0;
+    e->build_us_sum += e->step_us;
+    e->stats.build_us = e->build_us_sum / e->stats.builds;
+}
+
+/**
+ * @brief 执行界面的创建步骤，超出budget_us（0为不限）时停在步骤之间，下次从中断处继续
+ * @note 至少执行一步；按上一步的耗时估计下一步，预计超出时不再开始
+ * @return 是否已创建完成
+ */
+static bool build_steps(cache_entry_t *e, uint32_t budget_us) {
+    int64_t t0 = esp_timer_get_time();
+    size_t before = mem_used();
+    size_t total = step_count(e);
+    uint32_t spent = 0;
+    uint32_t last = 0;
+
+    if (e->next_step == 0) {
+        e->step_us = 0;
+        e->step_mem = 0;
+        ui_mem_profile_build_begin(e->stats.name);
+    } else {
+        ui_mem_profile_build_resume(e->stats.name);
+    }
+    do {
+        if (e->steps != NULL) {
+            e->steps->steps[e->next_step]();
+        } else {
+            e->init();
+        }
+        e->next_step++;
+        uint32_t now = (uint32_t)(esp_timer_get_time() - t0);
+        last = now - spent;
+        spent = now;
+    } while (e->next_step < total && (budget_us == 0 || spent + last <= budget_us));
+
+    // 只统计本界面步骤内的耗时和内存，步骤之间其他模块的分配不计入
+    e->step_us += spent;
+    e->step_mem += (int32_t)mem_used() - (int32_t)before;
+    if (e->next_step < total) {
+        ui_mem_profile_build_suspend(e->stats.name);
+        s_building = e;
+        return false;
+    }
+    finish_build(e);
+    return true;
+}
+
+// 创建界面（预创建到一半时执行剩余步骤），返回耗时（微秒）
+static uint32_t build_entry(cache_entry_t *e) {
+    build_steps(e, 0);
+    return e->step_us;
+}
+
+void ui_screen_cache_load(lv_obj_t **screen, void (*init)(void), lv_scr_load_anim_t anim, int spd, int delay) {
+    cache_entry_t *e = find_entry(screen);
+    int64_t t0 = esp_timer_get_time();
+    uint32_t time = spd;
+
+    // 渲染跟不上时缩短切换动画或去掉渐变，与lvgl_pm共用测得的帧间隔
+    lv_pm_budget_scr_anim(&anim, &time);
+    spd = time;
+
+    if (e == NULL && (e = add_entry(screen, init, NULL)) == NULL) {
+        if (*screen == NULL) {
+            init();
+        }
+        lv_scr_load_anim(*screen, anim, spd, delay, false);
+        return;
+    }
+
+    e->last_use = ++s_use_seq;
+    if (*screen == NULL || e == s_building) {
+        if (*screen == NULL) {
+            ui_screen_cache_trim();  // 先腾出空间再创建
+        }
+        uint32_t us = build_entry(e);
+        e->prebuild = false;
+        lv_scr_load_anim(*screen, anim, spd, delay, false);
+        ESP_LOGI(TAG, "%s built in %lu us (+%lu B, avg hit %lu us)", e->stats.name, (unsigned long)us,
+                 (unsigned long)e->stats.mem_bytes, (unsigned long)e->stats.hit_us);
+        return;
+    }
+
+    lv_scr_load_anim(*screen, anim, spd, delay, false);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+    e->stats.hits++;
+    e->hit_us_sum += us;
+    e->stats.hit_us = e->hit_us_sum / e->stats.hits;
+    ESP_LOGI(TAG, "%s hit in %lu us (avg build %lu us)", e->stats.name, (unsigned long)us,
+             (unsigned long)e->stats.build_us);
+}
+
+// 后台预创建的下一个界面
+static cache_entry_t *next_prebuild(void) {
+    for (size_t i = 0; i < s_count; i++) {
+        if (s_entries[i].prebuild && *s_entries[i].screen == NULL) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+static bool prebuild_mem_ok(void) {
+#if !LV_MEM_CUSTOM
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (mon.used_pct > UI_PREBUILD_MEM_MAX_PCT) {
+        return false;
+    }
+#endif
+    return !over_budget();
+}
+
+/**
+ * @brief 预创建定时器：每次最多用UI_PREBUILD_BUDGET_US微秒执行创建步骤，触摸操作和界面切换期间暂停
+ * @note 创建到一半的界面停在步骤之间，下次继续（统计中的build_us是各步耗时之和）
+ */
+static void prebuild_timer_cb(lv_timer_t *timer) {
+    lv_disp_t *disp = lv_disp_get_default();
+
+    if (disp->prev_scr != NULL || disp->scr_to_load != NULL ||
+        lv_disp_get_inactive_time(disp) < UI_PREBUILD_IDLE_MS) {
+        return;
+    }
+
+    // 已开始的界面先创建完；开始下一个界面前检查内存，上一个界面使内存超出缓存上限
+    // （UI_CACHE_LV_MEM_MAX_PCT等）时不再继续，否则新建的界面会被立即删除
+    cache_entry_t *e = s_building;
+    if (e == NULL && (e = next_prebuild()) != NULL && !prebuild_mem_ok()) {
+        ESP_LOGI(TAG, "Memory budget reached, remaining screens are built on first visit");
+        for (size_t i = 0; i < s_count; i++) {
+            s_entries[i].prebuild = false;
+        }
+        e = NULL;
+    }
+
+    if (e != NULL) {
+        if (!build_steps(e, UI_PREBUILD_BUDGET_US)) {
+            return;
+        }
+        e->prebuild = false;
+        ESP_LOGI(TAG, "%s prebuilt in %lu us, %u steps (+%lu B)", e->stats.name, (unsigned long)e->step_us,
+                 (unsigned)step_count(e), (unsigned long)e->stats.mem_bytes);
+        if (next_prebuild() != NULL) {
+            return;
+        }
+    }
+    lv_timer_del(timer);
+    s_prebuild_timer = NULL;
+}
+
+void ui_screen_cache_prebuild(lv_obj_t **screen) {
+    cache_entry_t *e = find_entry(screen);
+
+    if (e == NULL || *screen != NULL) {
+        return;
+    }
+    e->prebuild = true;
+    if (s_prebuild_timer == NULL) {
+        s_prebuild_timer = lv_timer_create(prebuild_timer_cb, UI_PREBUILD_PERIOD_MS, NULL);
+    }
+}
+
+size_t ui_screen_cache_get_stats(ui_screen_stats_t *out, size_t max) {
+    size_t n = (s_count < max) ? s_count : max;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = s_entries[i].stats;
+    }
+    return n;
+}
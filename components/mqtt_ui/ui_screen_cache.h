@@ -0,0 +1,122 @@
+#ifndef _UI_SCREEN_CACHE_H
+#define _UI_SCREEN_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * @defgroup UI_CACHE_CONFIG 界面缓存配置
+ * @brief 界面在第一次进入时创建，超出内存预算时按最久未使用的顺序删除
+ * @{
+ */
+#define UI_CACHE_MAX_SCREENS      8            ///< 可登记的界面数量上限
+#define UI_CACHE_LV_MEM_MAX_PCT   70           ///< LVGL内存池使用率上限（%，LV_MEM_CUSTOM时不检查）
+#define UI_CACHE_HEAP_MIN_FREE    (32 * 1024)  ///< 内部RAM最少剩余（字节）
+/** @} */
+
+/**
+ * @defgroup UI_PREBUILD_CONFIG 后台预创建配置
+ * @brief 主界面显示后，用lv_timer分片创建其他界面，避免第一次进入时等待
+ * @{
+ */
+#define UI_PREBUILD_PERIOD_MS     50           ///< 预创建定时器周期
+#define UI_PREBUILD_BUDGET_US     8000         ///< 每次定时器最多占用的时间（微秒），至少执行一步
+#define UI_PREBUILD_IDLE_MS       300          ///< 距最后一次触摸超过此时间才继续预创建
+#define UI_PREBUILD_MEM_MAX_PCT   50           ///< LVGL内存池使用率超过此值时停止预创建（%）
+/** @} */
+
+#if UI_PREBUILD_MEM_MAX_PCT > UI_CACHE_LV_MEM_MAX_PCT
+#error "UI_PREBUILD_MEM_MAX_PCT must not exceed UI_CACHE_LV_MEM_MAX_PCT"
+#endif
+
+/**
+ * @brief 界面创建/删除时的回调（恢复或保存界面状态、解除外部引用）
+ */
+typedef void (*ui_screen_hook_t)(void);
+
+/**
+ * @brief 界面创建的一步（创建几个控件），按顺序执行完所有步骤等同于调用界面创建函数
+ */
+typedef void (*ui_screen_step_t)(void);
+
+/**
+ * @brief 界面的分步创建函数表
+ */
+typedef struct {
+    const ui_screen_step_t *steps;
+    size_t count;
+} ui_screen_steps_t;
+
+/**
+ * @brief 由步骤函数数组初始化ui_screen_steps_t
+ */
+#define UI_SCREEN_STEPS(fns) {(fns), sizeof(fns) / sizeof((fns)[0])}
+
+/**
+ * @brief 单个界面的统计
+ */
+typedef struct {
+    const char *name;
+    bool resident;        ///< 当前是否已创建
+    uint16_t builds;      ///< 创建次数
+    uint16_t hits;        ///< 命中次数（已创建直接加载）
+    uint32_t build_us;    ///< 平均创建耗时
+    uint32_t hit_us;      ///< 平均命中耗时
+    uint32_t mem_bytes;   ///< 最近一次创建占用的内存
+} ui_screen_stats_t;
+
+/**
+ * @brief 登记界面
+ * @param screen 界面对象变量（删除后置为NULL）
+ * @param init 界面创建函数
+ * @param name 名称（用于日志）
+ * @param pinned 常驻，不参与删除（被其他模块长期引用的界面）
+ * @param on_build 创建后调用，可为NULL
+ * @param on_evict 删除前调用，可为NULL
+ */
+void ui_screen_cache_register(lv_obj_t **screen, void (*init)(void), const char *name, bool pinned,
+                              ui_screen_hook_t on_build, ui_screen_hook_t on_evict);
+
+/**
+ * @brief 设置已登记界面的分步创建函数表，后台预创建时每次定时器只执行UI_PREBUILD_BUDGET_US内的步骤
+ * @note 没有设置时整个界面创建函数作为一步执行
+ */
+void ui_screen_cache_set_steps(lv_obj_t **screen, const ui_screen_steps_t *steps);
+
+/**
+ * @brief 加载界面，未创建时先创建（未登记的界面自动登记）
+ * @note 后台预创建到一半的界面先执行完剩余步骤
+ * @note 切换动画按过渡期间测得的帧间隔调整（见lvgl_pm的pm_budget.h）：帧率不足时缩短时间、渐变换成平移或直接切换
+ */
+void ui_screen_cache_load(lv_obj_t **screen, void (*init)(void), lv_scr_load_anim_t anim, int spd, int delay);
+
+/**
+ * @brief 把已登记的界面加入后台预创建队列（按登记顺序创建）
+ * @note 预创建受UI_PREBUILD_*限制：每次定时器按分步创建函数表执行不超过UI_PREBUILD_BUDGET_US的步骤，
+ *       下次从中断处继续；开始创建下一个界面前内存使用率超过UI_PREBUILD_MEM_MAX_PCT或超出缓存上限时
+ *       放弃剩余界面，改为第一次进入时创建
+ */
+void ui_screen_cache_prebuild(lv_obj_t **screen);
+
+/**
+ * @brief 超出内存预算时删除最久未使用的非常驻界面（当前界面和正在切换的界面除外）
+ */
+void ui_screen_cache_trim(void);
+
+/**
+ * @brief 获取界面统计
+ * @return 写入的条数
+ */
+size_t ui_screen_cache_get_stats(ui_screen_stats_t *out, size_t max);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
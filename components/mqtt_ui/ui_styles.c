@@ -0,0 +1,40 @@
+#include "ui_styles.h"
+
+static lv_style_t s_styles[UI_STYLE_COUNT];
+static bool s_inited = false;
+
+void ui_styles_init(void) {
+    if (s_inited) {
+        return;
+    }
+    for (int i = 0; i < UI_STYLE_COUNT; i++) {
+        lv_style_init(&s_styles[i]);
+    }
+
+    lv_style_set_bg_color(&s_styles[UI_STYLE_BTN_IDLE], lv_color_hex(0x2196F3));
+    lv_style_set_bg_color(&s_styles[UI_STYLE_BTN_ON], lv_color_hex(0x4CAF50));
+    lv_style_set_bg_color(&s_styles[UI_STYLE_BTN_DANGER], lv_color_hex(0xF44336));
+
+    lv_style_set_text_font(&s_styles[UI_STYLE_LABEL_SMALL], &lv_font_montserrat_12);
+
+    // 字体由mqtt_message_display设置（可能是字形缓存字体）
+    lv_style_set_bg_color(&s_styles[UI_STYLE_TEXTAREA_LOG], lv_color_hex(0x000000));
+    lv_style_set_text_color(&s_styles[UI_STYLE_TEXTAREA_LOG], lv_color_hex(0x00FF00));
+
+    s_inited = true;
+}
+
+lv_style_t * ui_style_get(ui_style_id_t id) {
+    return &s_styles[id];
+}
+
+void ui_style_add(lv_obj_t * obj, ui_style_id_t id) {
+    lv_obj_add_style(obj, &s_styles[id], LV_PART_MAIN | LV_STATE_DEFAULT);
+}
+
+void ui_style_set_btn(lv_obj_t * btn, ui_style_id_t id) {
+    lv_obj_remove_style(btn, &s_styles[UI_STYLE_BTN_IDLE], LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_remove_style(btn, &s_styles[UI_STYLE_BTN_ON], LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_remove_style(btn, &s_styles[UI_STYLE_BTN_DANGER], LV_PART_MAIN | LV_STATE_DEFAULT);
+    lv_obj_add_style(btn, &s_styles[id], LV_PART_MAIN | LV_STATE_DEFAULT);
+}
@@ -0,0 +1,50 @@
+#ifndef _UI_STYLES_H
+#define _UI_STYLES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "lvgl.h"
+
+/**
+ * @brief 界面共用的样式表
+ *
+ * 样式静态分配，所有界面的对象共用同一份属性。对象上的本地样式（lv_obj_set_style_*）
+ * 每个对象都要单独申请样式和属性数组，查找属性时也要先遍历本地样式。
+ */
+typedef enum {
+    UI_STYLE_BTN_IDLE,      ///< 按钮：可操作（蓝）
+    UI_STYLE_BTN_ON,        ///< 按钮：已生效（绿）
+    UI_STYLE_BTN_DANGER,    ///< 按钮：断开等危险操作（红）
+    UI_STYLE_LABEL_SMALL,   ///< 标签：小号字体
+    UI_STYLE_TEXTAREA_LOG,  ///< 输入框：日志区（黑底绿字）
+    UI_STYLE_COUNT
+} ui_style_id_t;
+
+/**
+ * @brief 初始化样式表（ui_app_init中在创建界面之前调用，可重复调用）
+ */
+void ui_styles_init(void);
+
+/**
+ * @brief 获取样式
+ */
+lv_style_t * ui_style_get(ui_style_id_t id);
+
+/**
+ * @brief 给对象的主体部分加上共用样式
+ */
+void ui_style_add(lv_obj_t * obj, ui_style_id_t id);
+
+/**
+ * @brief 设置按钮的颜色样式（先移除其他按钮颜色样式）
+ * @param id UI_STYLE_BTN_IDLE / UI_STYLE_BTN_ON / UI_STYLE_BTN_DANGER
+ */
+void ui_style_set_btn(lv_obj_t * btn, ui_style_id_t id);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif
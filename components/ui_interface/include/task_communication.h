@@ -92,9 +92,12 @@ typedef struct {
 
     /** @brief 接收到的MQTT消息数据 */
     struct {
-      char topic[64];     ///< 消息主题
-      char payload[256];  ///< 消息内容
-      int qos;            ///< 服务质量等级
+      char topic[64];        ///< 消息主题
+      char payload[256];     ///< 消息内容（原始字节，可能不是字符串）
+      uint16_t payload_len;  ///< 载荷实际长度
+      int qos;               ///< 服务质量等级
+      bool retained;         ///< 是否为保留消息
+      int64_t rx_time_us;    ///< 收到MQTT_EVENT_DATA时的esp_timer时间（微秒）
     } mqtt_received;
 
     /** @brief MQTT操作结果数据 */
@@ -12,13 +12,33 @@
 #define WIFI_PASS      "roll991-arm5"             ///< WiFi 密码
 #define MAXIMUM_RETRY  5                 ///< 最大重连次数
 
+/**
+ * @defgroup WIFI_FAST_CONFIG 快速重连配置
+ * @brief 上次连接成功的BSSID、信道和DHCP分配的地址保存在NVS中，启动时直接连接该AP并使用该地址，
+ *        失败时清除缓存，改为扫描全部信道并重新DHCP
+ * @{
+ */
+#define WIFI_FAST_ENABLE       1         ///< 为0时每次启动都扫描并DHCP
+#define WIFI_FAST_STATIC_IP    1         ///< 快速连接时直接使用缓存的地址（跳过DHCP）
+#define WIFI_FAST_MAX_BOOTS    8         ///< 连续使用缓存地址的启动次数上限，达到后DHCP一次以更新租约
+#define WIFI_FAST_TIMEOUT_MS   3000      ///< 快速连接超过此时间未获得地址时改为完整扫描
+#define WIFI_FAST_NVS_NS       "wifi_fast"  ///< NVS命名空间
+/** @} */
+
 //--------------------------事件组和Tag定义--------------------------------
 #define WIFI_CONNECTED_BIT BIT0                      ///< WiFi已连接事件位
 #define WIFI_FAIL_BIT      BIT1                      ///< WiFi连接失败事件位
 
 
 
-uint8_t wifi_init(void);                        ///< WiFi初始化函数
+uint8_t wifi_init(void);                        ///< WiFi初始化函数（调用前须已调用nvs_flash_init）
+
+/**
+ * @brief 本次启动从开始连接到获得IP的耗时
+ * @param[out] fast 是否使用了快速连接（可为NULL）
+ * @return 耗时（毫秒），未获得IP时为-1
+ */
+int32_t wifi_time_to_ip_ms(bool *fast);
 
 
 
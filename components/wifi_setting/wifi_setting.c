@@ -1,15 +1,188 @@
 #include <string.h>
+#include <stdio.h>
 #include "wifi_setting.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "nvs_flash.h"
 #include "esp_event.h"
 #include "esp_netif.h"
+#include "esp_mac.h"
+#include "esp_timer.h"
 
 static const char *TAG = "wifi_setting";                 ///< 日志输出TAG
 static int s_retry_num = 0;                          ///< 当前重连次数
 
 static EventGroupHandle_t s_wifi_event_group;        ///< WiFi事件组句柄
+static esp_netif_t *s_sta_netif = NULL;              ///< STA网络接口
+
+/**
+ * @brief 快速重连缓存（NVS中保存的上次连接结果）
+ */
+typedef struct {
+    uint32_t version;              ///< 结构版本，不一致时丢弃
+    char ssid[33];                 ///< 缓存对应的SSID，修改WIFI_SSID后缓存失效
+    uint8_t bssid[6];              ///< AP的MAC地址
+    uint8_t channel;               ///< AP的信道
+    uint8_t fast_boots;            ///< 连续使用缓存地址的启动次数
+    esp_netif_ip_info_t ip;        ///< DHCP分配的地址、掩码、网关
+    esp_ip4_addr_t dns;            ///< DHCP分配的DNS
+    uint32_t full_ms;              ///< 最近一次完整连接（扫描+DHCP）获得IP的耗时
+} wifi_fast_cache_t;
+
+#define WIFI_FAST_CACHE_VERSION 1
+#define WIFI_FAST_NVS_KEY       "cache"
+
+static wifi_fast_cache_t s_cache;                    ///< 已加载/待保存的缓存
+static volatile bool s_fast = false;                 ///< 正在使用缓存的BSSID和信道连接
+static bool s_static_ip = false;                     ///< 正在使用缓存的地址（DHCP已停止）
+static int64_t s_connect_start = 0;                  ///< 开始连接的时刻（微秒）
+static int32_t s_time_to_ip_ms = -1;                 ///< 获得IP的耗时
+static bool s_time_fast = false;                     ///< 获得IP时是否为快速连接
+
+static bool cache_load(wifi_fast_cache_t *cache) {
+    nvs_handle_t nvs;
+    size_t len = sizeof(*cache);
+
+    if (nvs_open(WIFI_FAST_NVS_NS, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    esp_err_t err = nvs_get_blob(nvs, WIFI_FAST_NVS_KEY, cache, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*cache) && cache->version == WIFI_FAST_CACHE_VERSION &&
+           strcmp(cache->ssid, WIFI_SSID) == 0;
+}
+
+static void cache_save(const wifi_fast_cache_t *cache) {
+    nvs_handle_t nvs;
+
+    if (nvs_open(WIFI_FAST_NVS_NS, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(nvs, WIFI_FAST_NVS_KEY, cache, sizeof(*cache)) != ESP_OK || nvs_commit(nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "failed to save fast reconnect cache");
+    }
+    nvs_close(nvs);
+}
+
+static void cache_erase(void) {
+    nvs_handle_t nvs;
+
+    if (nvs_open(WIFI_FAST_NVS_NS, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    nvs_erase_key(nvs, WIFI_FAST_NVS_KEY);
+    nvs_commit(nvs);
+    nvs_close(nvs);
+}
+
+/**
+ * @brief 按缓存设置快速连接：指定BSSID和信道（不扫描其他信道），可选直接使用缓存的地址
+ * @param wifi_config 待设置的STA参数
+ * @return 是否使用快速连接
+ */
+static bool fast_prepare(wifi_config_t *wifi_config) {
+#if WIFI_FAST_ENABLE
+    if (!cache_load(&s_cache)) {
+        return false;
+    }
+    memcpy(wifi_config->sta.bssid, s_cache.bssid, sizeof(s_cache.bssid));
+    wifi_config->sta.bssid_set = true;
+    wifi_config->sta.channel = s_cache.channel;
+
+#if WIFI_FAST_STATIC_IP
+    // 连续使用一段时间后DHCP一次，以免路由器收回租约后地址冲突
+    if (s_cache.fast_boots < WIFI_FAST_MAX_BOOTS && esp_netif_dhcpc_stop(s_sta_netif) == ESP_OK) {
+        esp_netif_dns_info_t dns = {0};
+        dns.ip.type = ESP_IPADDR_TYPE_V4;
+        dns.ip.u_addr.ip4 = s_cache.dns;
+        esp_netif_set_ip_info(s_sta_netif, &s_cache.ip);
+        esp_netif_set_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+        s_static_ip = true;
+    }
+#endif
+    ESP_LOGI(TAG, "fast reconnect: BSSID " MACSTR " channel %u, %s", MAC2STR(s_cache.bssid), s_cache.channel,
+             s_static_ip ? "cached IP" : "DHCP");
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 快速连接失败：清除缓存，恢复DHCP，扫描全部信道重新连接
+ */
+static void fast_fallback(void) {
+    ESP_LOGW(TAG, "fast reconnect failed, falling back to full scan");
+    s_fast = false;
+    cache_erase();
+    if (s_static_ip) {
+        esp_netif_dhcpc_start(s_sta_netif);
+        s_static_ip = false;
+    }
+
+    wifi_config_t wifi_config;
+    esp_wifi_get_config(WIFI_IF_STA, &wifi_config);
+    wifi_config.sta.bssid_set = false;
+    wifi_config.sta.channel = 0;
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    s_retry_num = 0;
+    esp_wifi_connect();
+}
+
+/**
+ * @brief 获得IP后记录耗时并更新缓存
+ * @param ip_info 获得的地址
+ */
+static void fast_on_got_ip(const esp_netif_ip_info_t *ip_info) {
+    int32_t ms = (int32_t)((esp_timer_get_time() - s_connect_start) / 1000);
+    bool first = s_time_to_ip_ms < 0;
+
+    if (first) {
+        s_time_to_ip_ms = ms;
+        s_time_fast = s_fast;
+        if (s_fast && s_cache.full_ms > 0) {
+            ESP_LOGI(TAG, "time to IP: %ld ms (fast reconnect%s), full scan took %lu ms, saved %ld ms", (long)ms,
+                     s_static_ip ? ", cached IP" : "", (unsigned long)s_cache.full_ms,
+                     (long)s_cache.full_ms - (long)ms);
+        } else {
+            ESP_LOGI(TAG, "time to IP: %ld ms (%s)", (long)ms, s_fast ? "fast reconnect" : "full scan");
+        }
+    }
+
+#if WIFI_FAST_ENABLE
+    wifi_ap_record_t ap;
+    if (esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+        return;
+    }
+    uint32_t full_ms = (first && !s_fast) ? (uint32_t)ms : s_cache.full_ms;
+    if (s_static_ip) {
+        if (first) {
+            s_cache.fast_boots++;
+        }
+    } else {
+        // 地址来自DHCP，保存新的租约
+        esp_netif_dns_info_t dns;
+        memset(&s_cache, 0, sizeof(s_cache));
+        s_cache.ip = *ip_info;
+        if (esp_netif_get_dns_info(s_sta_netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK) {
+            s_cache.dns = dns.ip.u_addr.ip4;
+        }
+    }
+    s_cache.version = WIFI_FAST_CACHE_VERSION;
+    snprintf(s_cache.ssid, sizeof(s_cache.ssid), "%s", WIFI_SSID);
+    memcpy(s_cache.bssid, ap.bssid, sizeof(s_cache.bssid));
+    s_cache.channel = ap.primary;
+    s_cache.full_ms = full_ms;
+    cache_save(&s_cache);
+#endif
+}
+
+int32_t wifi_time_to_ip_ms(bool *fast) {
+    if (fast) {
+        *fast = s_time_fast;
+    }
+    return s_time_to_ip_ms;
+}
 
 /**
  * @brief WiFi事件回调处理函数
@@ -25,7 +198,9 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         esp_wifi_connect(); // 启动后立即尝试连接WiFi
     // 处理WiFi断开连接事件
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < MAXIMUM_RETRY) {
+        if (s_fast) {
+            fast_fallback();           // 缓存的AP或地址不可用，改为完整扫描
+        } else if (s_retry_num < MAXIMUM_RETRY) {
             esp_wifi_connect();        // 尝试重连
             s_retry_num++;             // 重连次数+1
             ESP_LOGI(TAG, "retry to connect to the AP");
@@ -38,6 +213,8 @@ static void wifi_event_handler(void* arg, esp_event_base_t event_base,
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "got ip: " IPSTR, IP2STR(&event->ip_info.ip));
         s_retry_num = 0; // 成功获取IP后，重试次数清零
+        fast_on_got_ip(&event->ip_info);
+        s_fast = false;  // 已连接，之后的断开按普通重连处理
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT); // 设置连接成功位
     }
 }
@@ -49,7 +226,7 @@ static void wifi_init_sta(void) {
     s_wifi_event_group = xEventGroupCreate();                       // 创建事件组
     ESP_ERROR_CHECK(esp_netif_init());                              // 初始化TCP/IP栈
     ESP_ERROR_CHECK(esp_event_loop_create_default());               // 创建默认事件循环
-    esp_netif_create_default_wifi_sta();                            // 创建默认STA网络接口
+    s_sta_netif = esp_netif_create_default_wifi_sta();              // 创建默认STA网络接口
 
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();            // 获取WiFi初始化默认参数
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));                           // 初始化WiFi驱动
@@ -75,17 +252,29 @@ static void wifi_init_sta(void) {
     strcpy((char *)wifi_config.sta.ssid, WIFI_SSID);
     strcpy((char *)wifi_config.sta.password, WIFI_PASS);
     wifi_config.sta.threshold.authmode = WIFI_AUTH_WPA2_PSK;
+    s_fast = fast_prepare(&wifi_config);                            // 有缓存时直接连接上次的AP
 
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));              // 设置为STA模式
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));// 设置STA参数
+    s_connect_start = esp_timer_get_time();
     ESP_ERROR_CHECK(esp_wifi_start());                              // 启动WiFi
 
-    // 等待连接结果
-    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
-            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-            pdFALSE,
-            pdFALSE,
-            portMAX_DELAY);
+    // 等待连接结果，快速连接超时后断开，由断开事件改为完整扫描
+    EventBits_t bits = 0;
+    if (s_fast) {
+        bits = xEventGroupWaitBits(s_wifi_event_group, WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
+                                   pdFALSE, pdFALSE, pdMS_TO_TICKS(WIFI_FAST_TIMEOUT_MS));
+        if (bits == 0 && s_fast) {
+            esp_wifi_disconnect();
+        }
+    }
+    if (bits == 0) {
+        bits = xEventGroupWaitBits(s_wifi_event_group,
+                WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
+                pdFALSE,
+                pdFALSE,
+                portMAX_DELAY);
+    }
 
     // 连接成功/失败日志输出
     if (bits & WIFI_CONNECTED_BIT) {
@@ -100,15 +289,7 @@ static void wifi_init_sta(void) {
 }
 
 uint8_t wifi_init(void) {
-    // 初始化NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase()); // 如果NVS初始化失败，擦除NVS
-        ret = nvs_flash_init();             // 重新初始化NVS
-    }
-    ESP_ERROR_CHECK(ret);
-
-    // 初始化WiFi连接
+    // 初始化WiFi连接（NVS由调用者在此之前初始化）
     wifi_init_sta();
 
     return 0; // 返回0表示初始化成功
@@ -0,0 +1,137 @@
+#include "boot-graph.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/event_groups.h"
+#include "freertos/task.h"
+
+static const char *TAG = "boot";
+
+typedef enum {
+    STAGE_PENDING = 0,
+    STAGE_DONE,
+    STAGE_FAILED,
+    STAGE_SKIPPED,
+} stage_state_t;
+
+typedef struct {
+    const boot_stage_t *stage;
+    stage_state_t state;
+    int64_t ready_us;   ///< 依赖全部完成的时刻
+    int64_t start_us;
+    int64_t end_us;
+    int core;           ///< 实际运行的核心
+} stage_run_t;
+
+static stage_run_t s_runs[BOOT_GRAPH_MAX_STAGES];
+static size_t s_count;
+static EventGroupHandle_t s_done;  ///< 每个步骤结束（无论成功与否）置一位
+
+static void stage_task(void *arg) {
+    stage_run_t *run = (stage_run_t *)arg;
+    const boot_stage_t *stage = run->stage;
+
+    if (stage->deps) {
+        xEventGroupWaitBits(s_done, stage->deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    run->ready_us = esp_timer_get_time();
+    run->core = xPortGetCoreID();
+
+    bool deps_ok = true;
+    for (size_t i = 0; i < s_count; i++) {
+        if ((stage->deps & BOOT_DEP(i)) && s_runs[i].state != STAGE_DONE) {
+            deps_ok = false;
+        }
+    }
+
+    run->start_us = esp_timer_get_time();
+    if (!deps_ok) {
+        run->state = STAGE_SKIPPED;
+    } else {
+        esp_err_t ret = stage->fn();
+        run->state = (ret == ESP_OK) ? STAGE_DONE : STAGE_FAILED;
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Stage %s failed: %s", stage->name, esp_err_to_name(ret));
+        }
+    }
+    run->end_us = esp_timer_get_time();
+
+    xEventGroupSetBits(s_done, BOOT_DEP(run - s_runs));
+    vTaskDelete(NULL);
+}
+
+static const char *state_name(stage_state_t state) {
+    switch (state) {
+    case STAGE_DONE:    return "ok";
+    case STAGE_FAILED:  return "FAILED";
+    case STAGE_SKIPPED: return "skipped";
+    default:            return "?";
+    }
+}
+
+static void report(int64_t t0) {
+    int64_t serial_us = 0;
+    int64_t end_us = t0;
+
+    ESP_LOGI(TAG, "%-10s %8s %8s %8s %8s %4s  %s", "stage", "ready", "start", "end", "took", "core", "result");
+    for (size_t i = 0; i < s_count; i++) {
+        const stage_run_t *run = &s_runs[i];
+        int64_t took = run->end_us - run->start_us;
+        serial_us += took;
+        if (run->end_us > end_us) {
+            end_us = run->end_us;
+        }
+        // 时间为启动以来的毫秒数，ready到start之间为等待调度
+        ESP_LOGI(TAG, "%-10s %8lld %8lld %8lld %8lld %4d  %s", run->stage->name, run->ready_us / 1000,
+                 run->start_us / 1000, run->end_us / 1000, took / 1000, run->core, state_name(run->state));
+    }
+    ESP_LOGI(TAG, "Boot stages finished in %lld ms (%lld ms if run in sequence)", (end_us - t0) / 1000,
+             serial_us / 1000);
+}
+
+esp_err_t boot_graph_run(const boot_stage_t *stages, size_t count) {
+    if (count == 0 || count > BOOT_GRAPH_MAX_STAGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (size_t i = 0; i < count; i++) {
+        // 只能依赖表中靠前的步骤，这样不会出现循环依赖
+        if (stages[i].fn == NULL || (stages[i].deps & ~(BOOT_DEP(i) - 1)) != 0) {
+            ESP_LOGE(TAG, "Invalid stage %s", stages[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    s_done = xEventGroupCreate();
+    if (s_done == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_count = count;
+    int64_t t0 = esp_timer_get_time();
+
+    for (size_t i = 0; i < count; i++) {
+        stage_run_t *run = &s_runs[i];
+        run->stage = &stages[i];
+        run->state = STAGE_PENDING;
+        run->core = -1;
+        if (xTaskCreatePinnedToCore(stage_task, stages[i].name, stages[i].stack ? stages[i].stack : BOOT_GRAPH_STACK,
+                                    run, BOOT_GRAPH_PRIORITY, NULL, stages[i].core) != pdPASS) {
+            // 任务创建失败按失败处理，依赖它的步骤会跳过
+            ESP_LOGE(TAG, "Failed to start stage %s", stages[i].name);
+            run->state = STAGE_FAILED;
+            run->ready_us = run->start_us = run->end_us = esp_timer_get_time();
+            xEventGroupSetBits(s_done, BOOT_DEP(i));
+        }
+    }
+
+    xEventGroupWaitBits(s_done, BOOT_DEP(count) - 1, pdFALSE, pdTRUE, portMAX_DELAY);
+    report(t0);
+
+    esp_err_t ret = ESP_OK;
+    for (size_t i = 0; i < count; i++) {
+        if (s_runs[i].state != STAGE_DONE) {
+            ret = ESP_FAIL;
+        }
+    }
+    vEventGroupDelete(s_done);
+    s_done = NULL;
+    return ret;
+}
@@ -0,0 +1,40 @@
+#ifndef BOOT_GRAPH_H
+#define BOOT_GRAPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @defgroup BOOT_GRAPH_CONFIG 启动流程配置
+ * @brief 启动步骤声明依赖关系，依赖都完成后在各自的任务中并行执行
+ * @{
+ */
+#define BOOT_GRAPH_MAX_STAGES  16     ///< 启动步骤数量上限（不超过事件组的位数）
+#define BOOT_GRAPH_STACK       4096   ///< 步骤未指定栈大小时使用
+#define BOOT_GRAPH_PRIORITY    5      ///< 步骤任务优先级
+/** @} */
+
+#define BOOT_DEP(i) (1UL << (i))      ///< 依赖第i个步骤
+
+/**
+ * @brief 启动步骤
+ */
+typedef struct {
+    const char *name;          ///< 名称（用于报告）
+    esp_err_t (*fn)(void);     ///< 执行函数，返回错误时依赖它的步骤跳过
+    uint32_t deps;             ///< 依赖的步骤（BOOT_DEP按位或）
+    uint32_t stack;            ///< 任务栈大小，0使用BOOT_GRAPH_STACK
+    BaseType_t core;           ///< 运行的核心，tskNO_AFFINITY不限
+} boot_stage_t;
+
+/**
+ * @brief 执行启动步骤，全部结束（完成、失败或跳过）后返回，并输出各步骤的耗时
+ * @param stages 步骤表，依赖只能指向表中的步骤
+ * @param count 步骤数量
+ * @return ESP_OK全部成功；ESP_FAIL有步骤失败或跳过；ESP_ERR_INVALID_ARG步骤表无效
+ */
+esp_err_t boot_graph_run(const boot_stage_t *stages, size_t count);
+
+#endif  // !BOOT_GRAPH_H
@@ -0,0 +1,135 @@
+#include "core-load.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "freertos/task.h"
+
+static const char *TAG = "core_load";
+
+#define LVGL_TASK_NAME "LVGL task"  // esp_lvgl_port创建的任务名
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static core_load_stats_t s_stats;
+
+#if configGENERATE_RUN_TIME_STATS
+
+static TaskStatus_t s_prev[CORE_LOAD_MAX_TASKS];
+static TaskStatus_t s_cur[CORE_LOAD_MAX_TASKS];
+static UBaseType_t s_prev_n = 0;
+static uint32_t s_prev_total = 0;
+
+// 任务绑定的核心，未绑定时返回-1
+// （TaskStatus_t::xCoreID依赖格式化函数选项，直接按任务句柄查询）
+static int task_core(const TaskStatus_t *t) {
+    BaseType_t core = xTaskGetCoreID(t->xHandle);
+    return (core == tskNO_AFFINITY) ? -1 : (int)core;
+}
+
+// 上一周期以来的运行时间
+static uint32_t task_delta(const TaskStatus_t *t) {
+    for (UBaseType_t i = 0; i < s_prev_n; i++) {
+        if (s_prev[i].xTaskNumber == t->xTaskNumber) {
+            return t->ulRunTimeCounter - s_prev[i].ulRunTimeCounter;
+        }
+    }
+    return t->ulRunTimeCounter;  // 本周期新建的任务
+}
+
+static void sample(void) {
+    uint32_t total;
+    UBaseType_t n = uxTaskGetSystemState(s_cur, CORE_LOAD_MAX_TASKS, &total);
+    uint32_t dt = total - s_prev_total;
+    core_load_stats_t st = {0};
+    uint8_t pct[CORE_LOAD_MAX_TASKS];
+    char report[256];
+    int len = 0;
+
+    if (n == 0) {
+        ESP_LOGW(TAG, "More than %d tasks, increase CORE_LOAD_MAX_TASKS", CORE_LOAD_MAX_TASKS);
+        return;
+    }
+    if (s_prev_n == 0 || dt == 0) {
+        goto save;
+    }
+
+    // 运行时间按单核计：每个核心每周期的容量都是dt
+    for (UBaseType_t i = 0; i < n; i++) {
+        uint64_t p = (uint64_t)task_delta(&s_cur[i]) * 100 / dt;
+        pct[i] = (p > 100) ? 100 : (uint8_t)p;
+        int core = task_core(&s_cur[i]);
+        if (strncmp(s_cur[i].pcTaskName, "IDLE", 4) == 0 && core >= 0 && core < portNUM_PROCESSORS) {
+            st.load[core] = 100 - pct[i];
+        } else if (strcmp(s_cur[i].pcTaskName, LVGL_TASK_NAME) == 0) {
+            st.lvgl_pct = pct[i];
+            st.lvgl_core = (core >= 0) ? core : 0;
+        }
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        len += snprintf(report + len, sizeof(report) - len, "core%d %u%% ", c, st.load[c]);
+    }
+    len += snprintf(report + len, sizeof(report) - len, "|");
+    for (UBaseType_t i = 0; i < n && len < (int)sizeof(report); i++) {
+        if (pct[i] < CORE_LOAD_REPORT_MIN_PCT || strncmp(s_cur[i].pcTaskName, "IDLE", 4) == 0) {
+            continue;
+        }
+        int core = task_core(&s_cur[i]);
+        len += snprintf(report + len, sizeof(report) - len, " %s@%c %u%%", s_cur[i].pcTaskName,
+                        core >= 0 ? '0' + core : '*', pct[i]);
+    }
+    ESP_LOGI(TAG, "%s", report);
+
+    // LVGL所在核心繁忙时，列出同核心上占用较高的其他任务
+    if (st.load[st.lvgl_core] >= CORE_LOAD_BUSY_PCT) {
+        for (UBaseType_t i = 0; i < n; i++) {
+            if (task_core(&s_cur[i]) == st.lvgl_core && pct[i] >= CORE_LOAD_CONTEND_PCT &&
+                strcmp(s_cur[i].pcTaskName, LVGL_TASK_NAME) != 0 && strncmp(s_cur[i].pcTaskName, "IDLE", 4) != 0) {
+                ESP_LOGW(TAG, "Contention on core %u (%u%%): " LVGL_TASK_NAME " %u%%, %s %u%%", st.lvgl_core,
+                         st.load[st.lvgl_core], st.lvgl_pct, s_cur[i].pcTaskName, pct[i]);
+                st.contended = 1;
+            }
+        }
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    st.samples = s_stats.samples + 1;
+    s_stats = st;
+    portEXIT_CRITICAL(&s_lock);
+
+save:
+    memcpy(s_prev, s_cur, n * sizeof(TaskStatus_t));
+    s_prev_n = n;
+    s_prev_total = total;
+}
+
+static void core_load_task(void *arg) {
+    while (1) {
+        sample();
+        vTaskDelay(pdMS_TO_TICKS(CORE_LOAD_PERIOD_MS));
+    }
+}
+
+esp_err_t core_load_start(void) {
+    if (xTaskCreate(core_load_task, "core_load", CORE_LOAD_TASK_STACK, NULL, CORE_LOAD_TASK_PRIORITY, NULL) !=
+        pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t core_load_start(void) {
+    ESP_LOGW(TAG, "CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS is not enabled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
+void core_load_get(core_load_stats_t *stats) {
+    portENTER_CRITICAL(&s_lock);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+}
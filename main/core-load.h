@@ -0,0 +1,58 @@
+#ifndef CORE_LOAD_H
+#define CORE_LOAD_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+/**
+ * @defgroup CORE_PLAN 任务核心分配
+ * @brief 渲染与网络分开在两个核心上运行，互不抢占
+ *
+ * - 核心0（PRO_CPU）：Wi-Fi、lwIP、esp-mqtt和主逻辑任务（由sdkconfig.defaults固定网络栈）
+ * - 核心1（APP_CPU）：LVGL任务和GUI任务
+ * @{
+ */
+#define APP_CORE_NET   0  ///< 网络栈所在核心（须与sdkconfig.defaults中Wi-Fi/lwIP/MQTT的核心选项一致）
+#define APP_CORE_LOGIC 0  ///< 主逻辑任务（与MQTT交互，和网络栈放在一起）
+#define APP_CORE_LVGL  1  ///< esp_lvgl_port的LVGL任务
+#define APP_CORE_GUI   1  ///< GUI任务（持有LVGL锁更新界面，和LVGL任务放在一起）
+/** @} */
+
+/**
+ * @defgroup CORE_LOAD_CONFIG 核心负载监测配置
+ * @{
+ */
+#define CORE_LOAD_PERIOD_MS      5000  ///< 采样周期（毫秒）
+#define CORE_LOAD_MAX_TASKS      32    ///< 最多统计的任务数
+#define CORE_LOAD_REPORT_MIN_PCT 2     ///< 报告中列出的任务最低占用（%）
+#define CORE_LOAD_BUSY_PCT       80    ///< 核心负载超过此值视为繁忙
+#define CORE_LOAD_CONTEND_PCT    10    ///< 与LVGL同核心的其他任务占用超过此值视为争用
+#define CORE_LOAD_TASK_STACK     3072  ///< 监测任务栈大小
+#define CORE_LOAD_TASK_PRIORITY  1     ///< 监测任务优先级
+/** @} */
+
+/**
+ * @brief 最近一个采样周期的负载统计
+ */
+typedef struct {
+    uint8_t load[portNUM_PROCESSORS];  ///< 各核心负载（%）
+    uint8_t lvgl_pct;                  ///< LVGL任务占用（%，按单核计）
+    uint8_t lvgl_core;                 ///< LVGL任务所在核心
+    uint8_t contended;                 ///< LVGL所在核心是否繁忙且有其他任务争用
+    uint32_t samples;                  ///< 已完成的采样周期数
+} core_load_stats_t;
+
+/**
+ * @brief 启动核心负载监测任务（需要CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS）
+ * @note 每个周期输出一次报告：各核心负载、占用较高的任务及其核心，LVGL所在核心出现争用时输出警告
+ * @return ESP_OK成功，ESP_ERR_NOT_SUPPORTED未启用运行时间统计
+ */
+esp_err_t core_load_start(void);
+
+/**
+ * @brief 获取最近一个采样周期的统计
+ */
+void core_load_get(core_load_stats_t *stats);
+
+#endif  // !CORE_LOAD_H
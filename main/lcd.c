@@ -1,8 +1,11 @@
 #include "lcd.h"
 
 #include "driver/i2c.h"      // 旧版I2C头文件
+#include "esp_attr.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "freertos/semphr.h"
 
 // 日志TAG定义
 static const char *TAG = "esp32_s3_lcd";
@@ -149,6 +152,94 @@ void dvp_pwdn(uint8_t level) {
 
 /****************    LCD显示屏 ↓   *************************/
 
+#define LCD_TRANS_RING 16  // 传输归属记录环大小（须大于队列深度）
+
+// 颜色传输的归属：SPI传输按提交顺序完成，完成中断按序号查表分发
+typedef enum {
+    LCD_OWNER_DRAW = 0,  // lcd_draw_bitmap提交（LVGL刷新），转发给注册的回调
+    LCD_OWNER_FILL,      // 填充引擎或同步绘图提交，由提交方等待最后一次完成
+    LCD_OWNER_BLIT,      // 图片分条传输提交，完成时归还中转缓冲区
+} lcd_trans_owner_t;
+
+static esp_lcd_panel_io_handle_t s_io = NULL;                      // LCD IO句柄
+static esp_lcd_panel_io_color_trans_done_cb_t s_color_done = NULL;  // 转发的传输完成回调
+static void *s_color_done_ctx = NULL;
+static uint8_t s_owner[LCD_TRANS_RING];                             // 各序号传输的归属
+static uint32_t s_submitted = 0;                                    // 已提交的颜色传输数
+static volatile uint32_t s_completed = 0;                           // 已完成的颜色传输数
+static volatile uint32_t s_fill_ticket = 0;                         // 填充引擎等待的完成数
+static SemaphoreHandle_t s_fill_done = NULL;
+static SemaphoreHandle_t s_blit_free = NULL;                        // 空闲的图片中转缓冲区数
+
+/**
+ * @brief 颜色传输完成中断：按提交顺序分发给填充引擎或注册的回调
+ */
+static bool IRAM_ATTR lcd_color_trans_done(esp_lcd_panel_io_handle_t panel_io,
+                                           esp_lcd_panel_io_event_data_t *edata, void *user_ctx) {
+    BaseType_t woken = pdFALSE;
+    uint32_t seq = s_completed;
+
+    s_completed = seq + 1;
+    switch (s_owner[seq % LCD_TRANS_RING]) {
+    case LCD_OWNER_FILL:
+        if (seq + 1 == s_fill_ticket) {
+            xSemaphoreGiveFromISR(s_fill_done, &woken);
+        }
+        return woken == pdTRUE;
+    case LCD_OWNER_BLIT:
+        xSemaphoreGiveFromISR(s_blit_free, &woken);
+        return woken == pdTRUE;
+    default:
+        break;
+    }
+    if (s_color_done != NULL) {
+        return s_color_done(panel_io, edata, s_color_done_ctx);
+    }
+    return false;
+}
+
+/**
+ * @brief 提交一次颜色传输并记录归属
+ */
+static esp_err_t lcd_submit(uint8_t owner, esp_lcd_panel_handle_t panel_handle, int x_start, int y_start,
+                            int x_end, int y_end, const void *color_data) {
+    // 先记录归属再提交，传输可能在draw_bitmap返回前完成
+    s_owner[s_submitted % LCD_TRANS_RING] = owner;
+    s_submitted++;
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    if (ret != ESP_OK) {
+        s_submitted--;
+    }
+    return ret;
+}
+
+/**
+ * @brief 注册LCD IO的传输完成分发回调
+ * @note esp_lvgl_port添加显示时会注册自己的回调，之后需重新注册
+ */
+static esp_err_t lcd_install_dispatcher(void) {
+    const esp_lcd_panel_io_callbacks_t cbs = {
+        .on_color_trans_done = lcd_color_trans_done,
+    };
+    return esp_lcd_panel_io_register_event_callbacks(s_io, &cbs, NULL);
+}
+
+/**
+ * @brief 注册颜色传输完成回调（lcd_draw_bitmap提交的传输完成时调用）
+ * @note 同时重新接管LCD IO的完成中断。调用时不能有通过其它途径提交的传输未完成
+ * @param cb 回调（中断上下文）
+ * @param user_ctx 回调参数
+ * @return esp_err_t 返回ESP_OK表示成功
+ */
+esp_err_t lcd_register_color_done(esp_lcd_panel_io_color_trans_done_cb_t cb, void *user_ctx) {
+    if (s_io == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_color_done = cb;
+    s_color_done_ctx = user_ctx;
+    return lcd_install_dispatcher();
+}
+
 /**
  * @brief LCD背光PWM初始化
  * @return esp_err_t 返回ESP_OK表示成功
@@ -245,9 +336,15 @@ esp_err_t bsp_display_new(esp_lcd_panel_handle_t *panel_handle,esp_lcd_panel_io_
         .lcd_cmd_bits = LCD_CMD_BITS,
         .lcd_param_bits = LCD_PARAM_BITS,
         .spi_mode = 2,
-        .trans_queue_depth = 10,
+        .trans_queue_depth = BSP_LCD_TRANS_QUEUE_DEPTH,
     };
     ESP_GOTO_ON_ERROR(esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)BSP_LCD_SPI_NUM, &io_config, io_handle), err, TAG, "New panel IO failed");
+    s_io = *io_handle;
+    if (s_fill_done == NULL) {
+        s_fill_done = xSemaphoreCreateBinary();
+        s_blit_free = xSemaphoreCreateCounting(2, 2);
+    }
+    ESP_GOTO_ON_ERROR(lcd_install_dispatcher(), err, TAG, "Register IO callbacks failed");
     ESP_LOGD(TAG, "Install LCD driver");
     const esp_lcd_panel_dev_config_t panel_config = {
         .reset_gpio_num = BSP_LCD_RST,
@@ -278,6 +375,8 @@ err:
 
 /**
  * @brief 显示图片
+ * @note 图片位于DMA可访问的内存时直接整块传输；位于Flash或PSRAM时分条拷贝到两块内部中转缓冲区，
+ *       拷贝下一条与传输上一条并行。返回时传输已全部完成
  * @param x_start 起始X坐标
  * @param y_start 起始Y坐标
  * @param x_end   结束X坐标
@@ -286,16 +385,149 @@ err:
  */
 void lcd_draw_picture(int x_start, int y_start, int x_end, int y_end, const unsigned char *gImage, esp_lcd_panel_handle_t *panel_handle)
 {
-    size_t pixels_byte_size = (x_end - x_start) * (y_end - y_start) * 2;
-    uint16_t *pixels = (uint16_t *)heap_caps_malloc(pixels_byte_size, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
-    if (NULL == pixels)
+    int w = x_end - x_start;
+    int h = y_end - y_start;
+    TickType_t timeout = pdMS_TO_TICKS(BSP_LCD_FILL_TIMEOUT_MS);
+
+    if (w <= 0 || h <= 0 || s_blit_free == NULL) {
+        return;
+    }
+
+    // 零拷贝：直接从原数据传输
+    if (esp_ptr_dma_capable(gImage)) {
+        xSemaphoreTake(s_fill_done, 0);
+        s_fill_ticket = s_submitted + 1;
+        if (lcd_submit(LCD_OWNER_FILL, *panel_handle, x_start, y_start, x_end, y_end, gImage) != ESP_OK ||
+            xSemaphoreTake(s_fill_done, timeout) != pdTRUE) {
+            ESP_LOGE(TAG, "Draw picture failed");
+        }
+        return;
+    }
+
+    int rows = (BSP_LCD_H_RES * BSP_LCD_BLIT_LINES) / w;
+    if (rows == 0) {
+        rows = 1;
+    } else if (rows > h) {
+        rows = h;
+    }
+    size_t stripe_bytes = (size_t)w * rows * sizeof(uint16_t);
+    uint8_t *bounce[2];
+    bounce[0] = heap_caps_malloc(stripe_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    bounce[1] = heap_caps_malloc(stripe_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (bounce[0] == NULL || bounce[1] == NULL)
     {
         ESP_LOGE(TAG, "Memory for bitmap is not enough");
+        heap_caps_free(bounce[0]);
+        heap_caps_free(bounce[1]);
         return;
     }
-    memcpy(pixels, gImage, pixels_byte_size);
-    esp_lcd_panel_draw_bitmap(*panel_handle, x_start, y_start, x_end, y_end, (uint16_t *)pixels);
-    heap_caps_free(pixels);
+
+    const uint8_t *src = gImage;
+    int idx = 0;
+    for (int y = y_start; y < y_end; y += rows) {
+        int n = (y_end - y < rows) ? y_end - y : rows;
+        size_t bytes = (size_t)w * n * sizeof(uint16_t);
+        if (xSemaphoreTake(s_blit_free, timeout) != pdTRUE) {
+            break;
+        }
+        memcpy(bounce[idx], src, bytes);
+        if (lcd_submit(LCD_OWNER_BLIT, *panel_handle, x_start, y, x_end, y + n, bounce[idx]) != ESP_OK) {
+            xSemaphoreGive(s_blit_free);
+            break;
+        }
+        src += bytes;
+        idx ^= 1;
+    }
+
+    // 两块中转缓冲区都归还后传输才全部完成
+    if (xSemaphoreTake(s_blit_free, timeout) != pdTRUE) {
+        ESP_LOGE(TAG, "Draw picture timeout");  // DMA可能仍在使用中转缓冲区，不释放
+        return;
+    }
+    if (xSemaphoreTake(s_blit_free, timeout) != pdTRUE) {
+        xSemaphoreGive(s_blit_free);
+        ESP_LOGE(TAG, "Draw picture timeout");
+        return;
+    }
+    xSemaphoreGive(s_blit_free);
+    xSemaphoreGive(s_blit_free);
+    heap_caps_free(bounce[0]);
+    heap_caps_free(bounce[1]);
+}
+
+/**
+ * @brief 提交一块颜色数据（LVGL刷新使用）
+ * @note 传输完成时调用lcd_register_color_done注册的回调
+ * @param x_start 起始X坐标
+ * @param y_start 起始Y坐标
+ * @param x_end   结束X坐标（不含）
+ * @param y_end   结束Y坐标（不含）
+ * @param color_data 颜色数据（传输完成前须保持有效）
+ * @return esp_err_t 返回ESP_OK表示成功
+ */
+esp_err_t lcd_draw_bitmap(esp_lcd_panel_handle_t panel_handle, int x_start, int y_start, int x_end, int y_end,
+                          const void *color_data) {
+    return lcd_submit(LCD_OWNER_DRAW, panel_handle, x_start, y_start, x_end, y_end, color_data);
+}
+
+/**
+ * @brief 用单色填充矩形区域
+ * @note 在内部DMA内存中构造一块多行图案，整块重复提交覆盖整个区域，返回时传输已全部完成。
+ *       LVGL运行后需持有LVGL锁调用
+ * @param x_start 起始X坐标
+ * @param y_start 起始Y坐标
+ * @param x_end   结束X坐标（不含）
+ * @param y_end   结束Y坐标（不含）
+ * @param color   RGB565颜色值（与draw_bitmap的像素格式相同）
+ * @return esp_err_t 返回ESP_OK表示成功
+ */
+esp_err_t lcd_fill_rect(esp_lcd_panel_handle_t panel_handle, int x_start, int y_start, int x_end, int y_end,
+                        uint16_t color) {
+    int w = x_end - x_start;
+    int h = y_end - y_start;
+
+    if (w <= 0 || h <= 0 || s_fill_done == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // 每次传输的行数：图案块容纳的整行数
+    int rows = (BSP_LCD_H_RES * BSP_LCD_FILL_BLOCK_LINES) / w;
+    if (rows > h) {
+        rows = h;
+    }
+    size_t pixels = (size_t)w * rows;
+    uint16_t *block = heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (block == NULL) {
+        ESP_LOGE(TAG, "Memory for fill block is not enough");
+        return ESP_ERR_NO_MEM;
+    }
+    // 先写一个像素，再成倍复制
+    block[0] = color;
+    for (size_t n = 1; n < pixels; n *= 2) {
+        memcpy(block + n, block, ((pixels - n < n) ? pixels - n : n) * sizeof(uint16_t));
+    }
+
+    int chunks = (h + rows - 1) / rows;
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(s_fill_done, 0);
+    s_fill_ticket = s_submitted + chunks;  // 先设定等待目标，最后一块可能在提交后立即完成
+    for (int y = y_start; y < y_end; y += rows) {
+        int y2 = (y + rows < y_end) ? y + rows : y_end;
+        ret = lcd_submit(LCD_OWNER_FILL, panel_handle, x_start, y, x_end, y2, block);
+        if (ret != ESP_OK) {
+            break;
+        }
+    }
+    if (ret == ESP_OK && xSemaphoreTake(s_fill_done, pdMS_TO_TICKS(BSP_LCD_FILL_TIMEOUT_MS)) != pdTRUE) {
+        ret = ESP_ERR_TIMEOUT;
+    }
+    if (ret != ESP_OK) {
+        // 提交失败或超时时无法确认DMA已停止使用图案块，宁可泄漏也不释放
+        ESP_LOGE(TAG, "Fill failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    heap_caps_free(block);
+    return ESP_OK;
 }
 
 /**
@@ -304,24 +536,7 @@ void lcd_draw_picture(int x_start, int y_start, int x_end, int y_end, const unsi
  */
 void lcd_set_color(uint16_t color, esp_lcd_panel_handle_t *panel_handle)
 {
-    uint16_t *buffer = (uint16_t *)heap_caps_malloc(BSP_LCD_H_RES * sizeof(uint16_t), MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
-    
-    if (NULL == buffer)
-    {
-        ESP_LOGE(TAG, "Memory for bitmap is not enough");
-    }
-    else
-    {
-        for (size_t i = 0; i < BSP_LCD_H_RES; i++)
-        {
-            buffer[i] = color;
-        }
-        for (int y = 0; y < 240; y++)
-        {
-            esp_lcd_panel_draw_bitmap(*panel_handle, 0, y, 320, y + 1, buffer);
-        }
-        heap_caps_free(buffer);
-    }
+    lcd_fill_rect(*panel_handle, 0, 0, BSP_LCD_H_RES, BSP_LCD_V_RES, color);
 }
 
 /**
@@ -21,7 +21,8 @@
 #define BSP_I2C_SCL (GPIO_NUM_2)  // SCL引脚
 
 #define BSP_I2C_NUM (0)         // I2C外设
-#define BSP_I2C_FREQ_HZ 100000  // 100kHz
+#define BSP_I2C_FAST_MODE (1)   // 1: 400kHz快速模式（FT5x06和PCA9557均支持），0: 100kHz标准模式
+#define BSP_I2C_FREQ_HZ (BSP_I2C_FAST_MODE ? 400000 : 100000)
 
 esp_err_t bsp_i2c_init(void);  // 初始化I2C接口
 
@@ -69,6 +70,11 @@ void dvp_pwdn(uint8_t level);
 #define BSP_LCD_RST (GPIO_NUM_NC)
 #define BSP_LCD_BACKLIGHT (GPIO_NUM_42)
 
+#define BSP_LCD_TRANS_QUEUE_DEPTH (10)  // SPI颜色传输队列深度
+#define BSP_LCD_FILL_BLOCK_LINES (24)   // 填充引擎图案块行数（内部DMA内存，满宽时约15KB）
+#define BSP_LCD_FILL_TIMEOUT_MS (1000)  // 填充等待传输完成的超时时间
+#define BSP_LCD_BLIT_LINES (4)          // 图片分条传输时每块内部中转缓冲区的行数（满宽时2.5KB，共两块）
+
 esp_err_t bsp_display_new(esp_lcd_panel_handle_t *panel_handle,esp_lcd_panel_io_handle_t *io_handle);
 
 esp_err_t bsp_display_brightness_init(void);
@@ -77,6 +83,11 @@ esp_err_t bsp_display_backlight_off(void);
 esp_err_t bsp_display_backlight_on(void);
 esp_err_t bsp_lcd_init(esp_lcd_panel_handle_t *panel_handle,esp_lcd_panel_io_handle_t *io_handle);
 void lcd_set_color(uint16_t color, esp_lcd_panel_handle_t *panel_handle);
+esp_err_t lcd_fill_rect(esp_lcd_panel_handle_t panel_handle, int x_start, int y_start, int x_end, int y_end,
+                        uint16_t color);
+esp_err_t lcd_draw_bitmap(esp_lcd_panel_handle_t panel_handle, int x_start, int y_start, int x_end, int y_end,
+                          const void *color_data);
+esp_err_t lcd_register_color_done(esp_lcd_panel_io_color_trans_done_cb_t cb, void *user_ctx);
 void lcd_draw_picture(int x_start, int y_start, int x_end, int y_end,
                       const unsigned char *gImage,
                       esp_lcd_panel_handle_t *panel_handle);
@@ -0,0 +1,164 @@
+#include "lvgl-bench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "esp_timer.h"
+#include "lcd.h"
+#include "lvgl-drawbuf.h"
+#include "lvgl-perf.h"
+#include "mqtt_glyph_cache.h"
+
+#if LV_USE_DEMO_BENCHMARK
+#include "lv_demos.h"
+#endif
+
+static const char *TAG = "lvgl_bench";
+
+#if LV_USE_DEMO_BENCHMARK
+
+/**
+ * @brief 从lv_demo_benchmark的标题（"序号/总数: 名称"）中解析场景总数和名称
+ * @note lv_demo_benchmark不导出场景表，标题是唯一的公开信息
+ */
+static bool parse_scene_title(char *name, size_t size, long *total) {
+    lv_obj_t *title = lv_obj_get_child(lv_scr_act(), 0);
+    if (title == NULL || !lv_obj_check_type(title, &lv_label_class)) {
+        return false;
+    }
+    const char *text = lv_label_get_text(title);
+    long index;
+    const char *sep = strstr(text, ": ");
+    if (sep == NULL || sscanf(text, "%ld/%ld", &index, total) != 2) {
+        return false;
+    }
+    snprintf(name, size, "%s", sep + 2);
+    return true;
+}
+
+/**
+ * @brief 用指定字体重绘一屏日志文字并输出平均耗时（对比字形缓存的效果）
+ */
+static void bench_glyph_font(lv_disp_t *disp, const char *name, const lv_font_t *font) {
+    static char text[1024];
+    bsp_perf_summary_t sum;
+    size_t len = 0;
+
+    for (int i = 0; len < sizeof(text) - 80 && i < 14; i++) {
+        len += snprintf(text + len, sizeof(text) - len,
+                        "[%03d] 12:00:%02d.%03d [Q1] sensors/room/temp: {\"t\":23.5,\"h\":41}\n", i, i, i * 37);
+    }
+
+    lvgl_port_lock(0);
+    lv_obj_t *prev = lv_scr_act();
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_t *label = lv_label_create(scr);
+    lv_obj_set_width(label, BSP_LCD_H_RES - 8);
+    lv_obj_set_style_text_font(label, font, 0);
+    lv_label_set_text_static(label, text);
+    lv_disp_load_scr(scr);
+    lv_refr_now(disp);  // 预热一帧
+
+    bsp_perf_init(disp);
+    bsp_perf_reset();
+    for (int i = 0; i < BSP_BENCH_GLYPH_FRAMES; i++) {
+        lv_obj_invalidate(scr);
+        lv_refr_now(disp);
+    }
+    bsp_drawbuf_wait_idle(disp, BSP_DRAW_BUF_FLUSH_TIMEOUT_MS);
+    bsp_perf_get_summary(&sum);
+    lv_disp_load_scr(prev);
+    lv_obj_del(scr);
+    lvgl_port_unlock();
+
+    printf("BENCH {\"type\":\"glyph\",\"font\":\"%s\",\"frames\":%lu,\"frame_us\":%lu,\"render_us\":%lu}\n",
+           name, (unsigned long)sum.samples, (unsigned long)sum.avg_frame_us, (unsigned long)sum.avg_render_us);
+}
+
+// 日志区字形缓存对比：同一屏文字先用基础字体、再用缓存字体绘制
+static void bench_glyph_cache(lv_disp_t *disp) {
+    const lv_font_t *base = &lv_font_montserrat_12;
+
+    bench_glyph_font(disp, "base", base);
+    const lv_font_t *cached = glyph_cache_create(base);
+    if (cached == base) {
+        ESP_LOGW(TAG, "Glyph cache unavailable, skip comparison");
+        return;
+    }
+    bench_glyph_font(disp, "cache", cached);
+}
+
+esp_err_t bsp_bench_run(lv_disp_t *disp) {
+    const bsp_draw_buf_cfg_t *cfg = bsp_drawbuf_current();
+    uint64_t fps_sum = 0, frame_sum = 0;
+    long total = 1;
+    long done = 0;
+
+    printf("BENCH {\"type\":\"config\",\"lvgl\":\"%d.%d.%d\",\"hres\":%d,\"vres\":%d,\"color_depth\":%d,"
+           "\"color_swap\":%d,\"pclk_hz\":%d,\"drawbuf\":\"%s\",\"lines\":%u,\"max_speed\":%d}\n",
+           LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH, BSP_LCD_H_RES, BSP_LCD_V_RES,
+           LV_COLOR_DEPTH, LV_COLOR_16_SWAP, BSP_LCD_PIXEL_CLOCK_HZ,
+           bsp_drawbuf_strategy_name(cfg->strategy), cfg->lines, BSP_BENCH_MAX_SPEED);
+
+    lv_demo_benchmark_set_max_speed(BSP_BENCH_MAX_SPEED);
+    for (long scene = 0; scene < total; scene++) {
+        char name[48];
+        bsp_perf_summary_t sum;
+
+        lvgl_port_lock(0);
+        lv_demo_benchmark_close();
+        lv_demo_benchmark_run_scene(scene);
+        bool ok = parse_scene_title(name, sizeof(name), &total);
+        bsp_perf_init(disp);  // 基准测试替换了monitor_cb，重新挂接计时回调
+        bsp_perf_reset();
+        bsp_perf_get_summary(&sum);
+        uint32_t frames0 = sum.frames;
+        int64_t t0 = esp_timer_get_time();
+        lvgl_port_unlock();
+
+        if (!ok) {
+            ESP_LOGW(TAG, "Scene %ld did not start", scene);
+            continue;
+        }
+        vTaskDelay(pdMS_TO_TICKS(BSP_BENCH_SCENE_MS));
+
+        lvgl_port_lock(0);
+        bsp_perf_get_summary(&sum);
+        int64_t elapsed_us = esp_timer_get_time() - t0;
+        lvgl_port_unlock();
+
+        uint32_t fps = (uint32_t)((uint64_t)(sum.frames - frames0) * 1000000 / elapsed_us);
+        printf("BENCH {\"type\":\"scene\",\"index\":%ld,\"name\":\"%s\",\"fps\":%lu,\"frames\":%lu,"
+               "\"frame_us\":%lu,\"max_frame_us\":%lu,\"render_us\":%lu,\"submit_us\":%lu,\"wait_us\":%lu,"
+               "\"dma_us\":%lu,\"areas\":%lu,\"px\":%lu,\"cpu\":%u}\n",
+               scene, name, (unsigned long)fps, (unsigned long)(sum.frames - frames0),
+               (unsigned long)sum.avg_frame_us, (unsigned long)sum.max_frame_us, (unsigned long)sum.avg_render_us,
+               (unsigned long)sum.avg_submit_us, (unsigned long)sum.avg_wait_us, (unsigned long)sum.avg_dma_us,
+               (unsigned long)sum.avg_areas, (unsigned long)sum.avg_px, sum.cpu);
+        fps_sum += fps;
+        frame_sum += sum.avg_frame_us;
+        done++;
+    }
+
+    lvgl_port_lock(0);
+    lv_demo_benchmark_close();
+    lvgl_port_unlock();
+
+    bench_glyph_cache(disp);
+
+    printf("BENCH {\"type\":\"summary\",\"scenes\":%ld,\"avg_fps\":%lu,\"avg_frame_us\":%lu}\n", done,
+           (unsigned long)(done ? fps_sum / done : 0), (unsigned long)(done ? frame_sum / done : 0));
+    ESP_LOGI(TAG, "Benchmark finished: %ld scenes", done);
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t bsp_bench_run(lv_disp_t *disp) {
+    ESP_LOGW(TAG, "CONFIG_LV_USE_DEMO_BENCHMARK is not enabled");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef LVGL_BENCH_H
+#define LVGL_BENCH_H
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+/**
+ * @defgroup BENCH_CONFIG LVGL基准测试配置
+ * @note 使用sdkconfig.bench构建（打开CONFIG_LV_USE_DEMO_BENCHMARK）时，启动后运行基准测试而不是正常界面，
+ *       构建命令见README
+ * @{
+ */
+#define BSP_BENCH_SCENE_MS  1100  ///< 每个场景的测量时长（毫秒，略长于lv_demo_benchmark的场景时长）
+#define BSP_BENCH_MAX_SPEED 0     ///< 置1时以最高帧率运行（刷新定时器周期设为1ms）。此时lv_timer_handler返回1，
+                                  ///< esp_lvgl_port会当作空闲睡眠BSP_LVGL_MAX_SLEEP_MS，测得的帧率偏低，默认关闭
+#define BSP_BENCH_GLYPH_FRAMES 30  ///< 日志字形缓存对比：基础字体和缓存字体各重绘的整屏帧数
+/** @} */
+
+/**
+ * @brief 依次运行lv_demo_benchmark的全部场景，每个场景结束后通过串口输出一行JSON结果
+ *
+ * 输出格式（每行一个JSON对象，以"BENCH "开头便于从日志中筛选）：
+ * - {"type":"config",...}  显示配置：分辨率、色深、SPI时钟、绘图缓冲区策略
+ * - {"type":"scene",...}   单个场景：帧率、平均/最大帧耗时、渲染/提交/等待/传输耗时
+ * - {"type":"glyph",...}   日志区文字分别用基础字体和字形缓存绘制的平均帧耗时/渲染耗时
+ * - {"type":"summary",...} 全部场景的平均值
+ *
+ * @note 阻塞直到全部场景运行完毕，不能在LVGL任务中调用，调用前不能持有LVGL锁
+ * @param disp LVGL显示（须已由bsp_lvgl_start初始化）
+ * @return ESP_OK成功，ESP_ERR_NOT_SUPPORTED未启用CONFIG_LV_USE_DEMO_BENCHMARK
+ */
+esp_err_t bsp_bench_run(lv_disp_t *disp);
+
+#endif  // !LVGL_BENCH_H
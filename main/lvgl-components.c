@@ -1,4 +1,8 @@
 #include "lvgl-components.h"
+#include "core-load.h"
+#include "lvgl-drawbuf.h"
+#include "lvgl-governor.h"
+#include "lvgl-perf.h"
 
 static esp_lcd_touch_handle_t tp = NULL;            // 触摸屏句柄
 static lv_disp_t *disp = NULL;                      // LVGL显示句柄
@@ -8,6 +12,10 @@ static lv_indev_t *disp_indev = NULL;               // LVGL输入设备句柄
 
 static const char *TAG = "esp32_s3_lvgl";  // 日志TAG定义
 
+static TaskHandle_t lvgl_task = NULL;               // esp_lvgl_port的LVGL任务
+static TaskHandle_t touch_wake_task = NULL;         // 触摸中断唤醒任务
+static void (*port_touch_read)(lv_indev_drv_t *, lv_indev_data_t *) = NULL;  // esp_lvgl_port的读取回调
+
 /**
  * @brief LCD显示初始化(带LVGL)
  * @return lv_disp_t* 返回LVGL显示句柄
@@ -23,7 +31,7 @@ static lv_disp_t *bsp_display_lcd_init(esp_lcd_panel_io_handle_t *io_handle,esp_
   const lvgl_port_display_cfg_t disp_cfg = {
       .io_handle = *io_handle,
       .panel_handle = *panel_handle,
-      .buffer_size = BSP_LCD_H_RES * BSP_LCD_DRAW_BUF_HEIGHT,  // LVGL缓存大小
+      .buffer_size = BSP_LCD_H_RES * BSP_LCD_DRAW_BUF_HEIGHT,  // 初始LVGL缓存大小（随后由bsp_drawbuf_setup替换）
       .double_buffer = false,                                  // 不使用双缓冲
       .hres = BSP_LCD_H_RES,
       .vres = BSP_LCD_V_RES,
@@ -56,7 +64,7 @@ esp_err_t bsp_touch_new(esp_lcd_touch_handle_t *ret_touch) {
       .x_max = BSP_LCD_V_RES,
       .y_max = BSP_LCD_H_RES,
       .rst_gpio_num = GPIO_NUM_NC,  // Shared with LCD reset
-      .int_gpio_num = GPIO_NUM_NC,  // Shared with LCD interrupt
+      .int_gpio_num = BSP_TOUCH_INT,
       .levels =
           {
               .reset = 0,
@@ -105,22 +113,158 @@ static lv_indev_t *bsp_display_indev_init(lv_disp_t *disp) {
   return lvgl_port_add_touch(&touch_cfg);
 }
 
+/**
+ * @brief 唤醒睡眠中的LVGL任务
+ * @note LVGL任务空闲时最长睡眠BSP_LVGL_MAX_SLEEP_MS，有新内容需要立即绘制时在释放LVGL锁后调用
+ */
+void bsp_lvgl_wake(void) {
+  if (lvgl_task != NULL) {
+    xTaskAbortDelay(lvgl_task);
+  }
+}
+
+/**
+ * @brief 触摸读取：按下或惯性滚动时按活动周期读取，松开后空闲
+ * @note 有触摸中断时空闲周期改为BSP_TOUCH_INT_FALLBACK_MS，由中断提前唤醒；
+ *       没有触摸中断时暂停读取定时器，由触摸唤醒任务每BSP_TOUCH_IDLE_READ_MS轮询一次，按下后恢复
+ */
+static void touch_read_cb(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+  port_touch_read(drv, data);
+
+  bool active = data->state == LV_INDEV_STATE_PRESSED || lv_indev_get_scroll_obj(disp_indev) != NULL;
+  if (active) {
+    lv_timer_set_period(drv->read_timer, BSP_TOUCH_ACTIVE_READ_MS);
+  } else if (BSP_TOUCH_INT == GPIO_NUM_NC) {
+    lv_timer_pause(drv->read_timer);
+  } else {
+    lv_timer_set_period(drv->read_timer, BSP_TOUCH_INT_FALLBACK_MS);
+  }
+}
+
+/**
+ * @brief 触摸中断（FT5x06有新数据时拉低INT）
+ */
+static void IRAM_ATTR touch_isr(esp_lcd_touch_handle_t tp) {
+  BaseType_t woken = pdFALSE;
+
+  vTaskNotifyGiveFromISR(touch_wake_task, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+/**
+ * @brief 读取定时器暂停或渲染暂停期间直接读取触摸
+ * @note 调用时持有LVGL锁，与LVGL任务中的读取互斥
+ */
+static bool touch_poll_pressed(void) {
+  uint16_t x, y;
+  uint8_t cnt = 0;
+
+  if (esp_lcd_touch_read_data(tp) != ESP_OK) {
+    return false;
+  }
+  return esp_lcd_touch_get_coordinates(tp, &x, &y, NULL, &cnt, 1) && cnt > 0;
+}
+
+/**
+ * @brief 触摸唤醒任务：让读取定时器立即到期并唤醒LVGL任务（LVGL对象不能在中断中操作）
+ * @note 有触摸中断时由中断通知；没有时每BSP_TOUCH_IDLE_READ_MS轮询一次触摸。
+ *       LVGL不读取触摸时（读取定时器暂停或渲染暂停）只有本任务读取触摸屏，
+ *       检测到按压后通知显示活动调节任务恢复渲染
+ */
+static void touch_wake_task_fn(void *arg) {
+  lv_timer_t *read_timer = disp_indev->driver->read_timer;
+  bool poll = BSP_TOUCH_INT == GPIO_NUM_NC;
+
+  while (1) {
+    if (poll) {
+      vTaskDelay(pdMS_TO_TICKS(BSP_TOUCH_IDLE_READ_MS));
+      if (!lvgl_port_lock(0)) {
+        continue;
+      }
+      bool pressed = (read_timer->paused || bsp_governor_state() == BSP_GOV_OFF) && touch_poll_pressed();
+      lvgl_port_unlock();
+      if (!pressed) {
+        continue;
+      }
+    } else {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    if (lvgl_port_lock(0)) {
+      lv_timer_set_period(read_timer, BSP_TOUCH_ACTIVE_READ_MS);
+      lv_timer_resume(read_timer);
+      lv_timer_ready(read_timer);
+      lvgl_port_unlock();
+    }
+    bsp_lvgl_wake();
+    bsp_governor_kick();  // 渲染暂停时立即恢复
+  }
+}
+
+/**
+ * @brief 启用按需触摸读取：连接了BSP_TOUCH_INT时由中断唤醒，否则空闲时暂停LVGL读取定时器并低频轮询
+ */
+static void bsp_touch_irq_init(void) {
+  bool poll = BSP_TOUCH_INT == GPIO_NUM_NC;
+
+  if (xTaskCreatePinnedToCore(touch_wake_task_fn, "touch_wake", 2048, NULL, 5, &touch_wake_task,
+                              APP_CORE_LVGL) != pdPASS) {
+    ESP_LOGE(TAG, "Create touch wake task failed, keep polling every %d ms", BSP_TOUCH_ACTIVE_READ_MS);
+    return;
+  }
+  if (!poll) {
+    gpio_set_intr_type(BSP_TOUCH_INT, GPIO_INTR_NEGEDGE);
+    if (esp_lcd_touch_register_interrupt_callback(tp, touch_isr) != ESP_OK) {
+      ESP_LOGE(TAG, "Register touch interrupt failed, keep polling");
+      vTaskDelete(touch_wake_task);
+      touch_wake_task = NULL;
+      return;
+    }
+  }
+
+  lvgl_port_lock(0);
+  port_touch_read = disp_indev->driver->read_cb;
+  disp_indev->driver->read_cb = touch_read_cb;
+  lvgl_port_unlock();
+  if (poll) {
+    ESP_LOGI(TAG, "Touch INT not connected, polling every %d ms while idle", BSP_TOUCH_IDLE_READ_MS);
+  } else {
+    ESP_LOGI(TAG, "Touch interrupt enabled on GPIO %d", BSP_TOUCH_INT);
+  }
+}
+
 /**
  * @brief 启动LVGL显示
- * @note 初始化LVGL、液晶屏和触摸屏，并打开液晶屏背光
+ * @note 初始化LVGL、液晶屏和触摸屏，打开液晶屏背光并启动显示活动调节
  */
 void bsp_lvgl_start(esp_lcd_panel_io_handle_t *io_handle, esp_lcd_panel_handle_t *panel_handle) {
   /* 初始化LVGL */
   lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+  lvgl_cfg.task_affinity = APP_CORE_LVGL;  // 与网络栈分开在不同核心
+  lvgl_cfg.task_max_sleep_ms = BSP_LVGL_MAX_SLEEP_MS;  // 空闲时睡眠，由触摸中断或新数据唤醒
   lvgl_port_init(&lvgl_cfg);
+  lvgl_task = xTaskGetHandle("LVGL task");
 
   /* 初始化液晶屏 并添加LVGL接口 */
   disp = bsp_display_lcd_init(io_handle, panel_handle);
 
+  /* 选择绘图缓冲区策略（NVS中没有校准结果时先校准，此时背光尚未打开） */
+  lvgl_port_lock(0);
+  bsp_drawbuf_setup(disp, *panel_handle, *io_handle);
+  bsp_perf_init(disp);  // 帧计时（渲染/提交/等待/传输）
+  lvgl_port_unlock();
+
   /* 初始化触摸屏 并添加LVGL接口 */
   disp_indev = bsp_display_indev_init(disp);
+  bsp_touch_irq_init();
 
   /* 打开液晶屏背光 */
   bsp_display_backlight_on();
+
+#if !LV_USE_DEMO_BENCHMARK
+  /* 按触摸活动调节刷新率和背光，长时间无操作时暂停渲染（基准测试需要固定刷新率） */
+  if (bsp_governor_init(disp, disp_indev) != ESP_OK) {
+    ESP_LOGE(TAG, "Start display governor failed");
+  }
+#endif
 }
 
@@ -5,10 +5,17 @@
 #include "esp_lcd_touch_ft5x06.h"
 #include "esp_lvgl_port.h"
 
-#define BSP_LCD_DRAW_BUF_HEIGHT    (20)  // LVGL绘图缓冲区高度
+#define BSP_LCD_DRAW_BUF_HEIGHT    (20)  // LVGL初始绘图缓冲区高度（PSRAM单缓冲）
+
+#define BSP_TOUCH_INT              (GPIO_NUM_NC)  // 触摸INT引脚（FT5x06低电平有效）。本板INT未接到ESP32-S3，为NC：空闲时暂停LVGL读取定时器，按BSP_TOUCH_IDLE_READ_MS轮询
+#define BSP_TOUCH_ACTIVE_READ_MS   (LV_INDEV_DEF_READ_PERIOD)  // 按下或惯性滚动时的读取周期
+#define BSP_TOUCH_IDLE_READ_MS     (50)    // INT为NC时，空闲期间（LVGL读取定时器暂停）的触摸轮询周期
+#define BSP_TOUCH_INT_FALLBACK_MS  (1000)  // 接了INT时，空闲状态的兜底读取周期
+#define BSP_LVGL_MAX_SLEEP_MS      (1000)  // LVGL任务空闲时的最长睡眠时间
 
 void bsp_lvgl_start(esp_lcd_panel_io_handle_t *io_handle,
                     esp_lcd_panel_handle_t *panel_handle);
+void bsp_lvgl_wake(void);  // 唤醒睡眠中的LVGL任务（在LVGL锁外调用）
 
 
 #endif // !LVGL_COMPONENTS_H
\ No newline at end of file
@@ -0,0 +1,428 @@
+#include "lvgl-drawbuf.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lvgl-components.h"
+#include "lvgl-perf.h"
+#include "nvs.h"
+
+static const char *TAG = "lvgl_drawbuf";
+
+#define BOUNCE_PIXELS (BSP_LCD_H_RES * BSP_DRAW_BUF_BOUNCE_LINES)  // 每块中转缓冲区的像素数
+#define CFG_VERSION   1                                            // NVS中配置结构的版本
+
+/**
+ * @brief NVS中保存的校准结果
+ */
+typedef struct {
+    uint8_t version;
+    bsp_draw_buf_cfg_t cfg;
+} drawbuf_nvs_t;
+
+/**
+ * @brief 校准候选配置（按预期速度从快到慢大致排列）
+ */
+static const bsp_draw_buf_cfg_t s_candidates[] = {
+    {BSP_DRAW_BUF_DMA_DOUBLE, 40, 0},
+    {BSP_DRAW_BUF_DMA_DOUBLE, 20, 0},
+    {BSP_DRAW_BUF_DMA_DOUBLE, 10, 0},
+    {BSP_DRAW_BUF_DMA_SINGLE, 80, 0},
+    {BSP_DRAW_BUF_DMA_SINGLE, 40, 0},
+    {BSP_DRAW_BUF_PSRAM_BOUNCE, BSP_LCD_V_RES, 0},
+    {BSP_DRAW_BUF_PSRAM_BOUNCE, 60, 0},
+    {BSP_DRAW_BUF_PSRAM_SINGLE, 20, 0},
+};
+
+static const char *s_strategy_names[BSP_DRAW_BUF_STRATEGY_MAX] = {
+    "psram-single", "dma-single", "dma-double", "psram-bounce",
+};
+
+static esp_lcd_panel_handle_t s_panel = NULL;
+static esp_lcd_panel_io_handle_t s_io = NULL;
+static lv_disp_drv_t *s_drv = NULL;
+static bsp_draw_buf_cfg_t s_cfg = {BSP_DRAW_BUF_PSRAM_SINGLE, 0, 0};
+static lv_color_t *s_buf[2] = {NULL, NULL};      // 本模块分配的绘图缓冲区（esp_lvgl_port分配的不在此列，不释放）
+static SemaphoreHandle_t s_flush_done = NULL;    // 每个区域传输完成时释放，等待传输结束时使用
+static volatile bool s_last_issued = false;      // 正在传输的区域是本帧最后一个
+static volatile uint32_t s_frames = 0;           // 传输完成的帧数
+
+// PSRAM+中转策略的状态
+static lv_color_t *s_bounce[2] = {NULL, NULL};
+static uint8_t s_bounce_idx = 0;
+static SemaphoreHandle_t s_bounce_free = NULL;  // 空闲的中转缓冲区数
+static atomic_int s_pending = 0;                // 已提交未完成的分条传输数
+static volatile bool s_all_issued = false;      // 当前区域的最后一条已提交
+
+size_t bsp_drawbuf_internal_bytes(const bsp_draw_buf_cfg_t *cfg) {
+    size_t line_bytes = BSP_LCD_H_RES * sizeof(lv_color_t);
+
+    switch (cfg->strategy) {
+    case BSP_DRAW_BUF_DMA_SINGLE:
+        return cfg->lines * line_bytes;
+    case BSP_DRAW_BUF_DMA_DOUBLE:
+        return 2 * cfg->lines * line_bytes;
+    case BSP_DRAW_BUF_PSRAM_BOUNCE:
+        return 2 * BOUNCE_PIXELS * sizeof(lv_color_t);
+    default:
+        return 0;
+    }
+}
+
+// 一个区域传输完成（中断上下文）
+static void flush_done_isr(BaseType_t *woken) {
+    bsp_perf_flush_done_isr();
+    lv_disp_flush_ready(s_drv);
+    if (s_last_issued) {
+        s_last_issued = false;
+        s_frames++;
+    }
+    xSemaphoreGiveFromISR(s_flush_done, woken);
+}
+
+// SPI颜色数据传输完成（中断上下文）
+static bool drawbuf_trans_done(esp_lcd_panel_io_handle_t panel_io, esp_lcd_panel_io_event_data_t *edata,
+                               void *user_ctx) {
+    BaseType_t woken = pdFALSE;
+
+    if (s_cfg.strategy != BSP_DRAW_BUF_PSRAM_BOUNCE) {
+        flush_done_isr(&woken);
+        return woken == pdTRUE;
+    }
+    xSemaphoreGiveFromISR(s_bounce_free, &woken);
+    if (atomic_fetch_sub(&s_pending, 1) == 1 && s_all_issued) {
+        s_all_issued = false;
+        flush_done_isr(&woken);
+    }
+    return woken == pdTRUE;
+}
+
+static void flush_direct(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map) {
+    s_last_issued = lv_disp_flush_is_last(drv);
+    bsp_perf_flush_begin(area);
+    lcd_draw_bitmap(s_panel, area->x1, area->y1, area->x2 + 1, area->y2 + 1, color_map);
+    bsp_perf_flush_end();
+}
+
+// 把PSRAM中的区域分条拷贝到内部中转缓冲区后传输，拷贝下一条与传输上一条并行
+static void flush_bounce(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map) {
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+    int32_t rows = BOUNCE_PIXELS / w;
+
+    s_last_issued = lv_disp_flush_is_last(drv);
+    bsp_perf_flush_begin(area);
+    for (int32_t y = 0; y < h; y += rows) {
+        int32_t n = (h - y < rows) ? h - y : rows;
+        xSemaphoreTake(s_bounce_free, portMAX_DELAY);
+        lv_color_t *dst = s_bounce[s_bounce_idx];
+        s_bounce_idx ^= 1;
+        memcpy(dst, color_map + y * w, n * w * sizeof(lv_color_t));
+        atomic_fetch_add(&s_pending, 1);
+        if (y + n >= h) {
+            s_all_issued = true;
+        }
+        lcd_draw_bitmap(s_panel, area->x1, area->y1 + y, area->x2 + 1, area->y1 + y + n, dst);
+    }
+    bsp_perf_flush_end();
+}
+
+#define WAIT_SLICE_MS 10  // 等待传输完成信号的时间片（毫秒）
+
+static bool flush_idle(const void *arg) {
+    return !((const lv_disp_draw_buf_t *)arg)->flushing;
+}
+
+static bool frame_changed(const void *arg) {
+    return s_frames != *(const uint32_t *)arg;
+}
+
+// 等待条件成立：按时间片等待区域传输完成的信号后重新检查，信号被其他等待者取走时最多多等一片
+static bool wait_until(bool (*cond)(const void *), const void *arg, uint32_t timeout_ms) {
+    TickType_t start = xTaskGetTickCount();
+
+    while (!cond(arg)) {
+        if (xTaskGetTickCount() - start >= pdMS_TO_TICKS(timeout_ms)) {
+            return cond(arg);
+        }
+        xSemaphoreTake(s_flush_done, pdMS_TO_TICKS(WAIT_SLICE_MS));
+    }
+    return true;
+}
+
+bool bsp_drawbuf_wait_idle(lv_disp_t *disp, uint32_t timeout_ms) {
+    lv_disp_draw_buf_t *draw_buf = disp->driver->draw_buf;
+
+    if (s_flush_done == NULL) {
+        return !draw_buf->flushing;
+    }
+    return wait_until(flush_idle, draw_buf, timeout_ms);
+}
+
+uint32_t bsp_drawbuf_frame_count(void) {
+    return s_frames;
+}
+
+bool bsp_drawbuf_wait_frame(uint32_t since, uint32_t timeout_ms) {
+    if (s_flush_done == NULL) {
+        return false;
+    }
+    return wait_until(frame_changed, &since, timeout_ms);
+}
+
+esp_err_t bsp_drawbuf_apply(lv_disp_t *disp, esp_lcd_panel_handle_t panel_handle,
+                            esp_lcd_panel_io_handle_t io_handle, const bsp_draw_buf_cfg_t *cfg) {
+    lv_color_t *buf1 = NULL, *buf2 = NULL;
+    lv_color_t *bounce[2] = {NULL, NULL};
+    uint32_t caps;
+    bool two;
+
+    if (disp == NULL || cfg == NULL || cfg->strategy >= BSP_DRAW_BUF_STRATEGY_MAX ||
+        cfg->lines == 0 || cfg->lines > BSP_LCD_V_RES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    switch (cfg->strategy) {
+    case BSP_DRAW_BUF_DMA_SINGLE:
+        caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+        two = false;
+        break;
+    case BSP_DRAW_BUF_DMA_DOUBLE:
+        caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+        two = true;
+        break;
+    case BSP_DRAW_BUF_PSRAM_BOUNCE:
+        caps = MALLOC_CAP_SPIRAM;
+        two = true;
+        break;
+    default:
+        caps = MALLOC_CAP_SPIRAM;
+        two = false;
+        break;
+    }
+
+    // 先分配新缓冲区，失败时保持原配置
+    size_t size = (size_t)BSP_LCD_H_RES * cfg->lines;
+    buf1 = heap_caps_malloc(size * sizeof(lv_color_t), caps);
+    if (two) {
+        buf2 = heap_caps_malloc(size * sizeof(lv_color_t), caps);
+    }
+    if (cfg->strategy == BSP_DRAW_BUF_PSRAM_BOUNCE) {
+        bounce[0] = heap_caps_malloc(BOUNCE_PIXELS * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+        bounce[1] = heap_caps_malloc(BOUNCE_PIXELS * sizeof(lv_color_t), MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+    if (buf1 == NULL || (two && buf2 == NULL) ||
+        (cfg->strategy == BSP_DRAW_BUF_PSRAM_BOUNCE && (bounce[0] == NULL || bounce[1] == NULL))) {
+        free(buf1);
+        free(buf2);
+        free(bounce[0]);
+        free(bounce[1]);
+        return ESP_ERR_NO_MEM;
+    }
+
+    if (s_flush_done == NULL) {
+        s_flush_done = xSemaphoreCreateBinary();
+        s_bounce_free = xSemaphoreCreateCounting(2, 2);
+    }
+
+    // 等待正在进行的传输结束后再替换回调和释放旧缓冲区（首次切换时仍由esp_lvgl_port的回调通知，按时间片轮询）
+    lv_disp_draw_buf_t *draw_buf = disp->driver->draw_buf;
+    if (!wait_until(flush_idle, draw_buf, BSP_DRAW_BUF_FLUSH_TIMEOUT_MS)) {
+        ESP_LOGE(TAG, "Flush did not finish in %d ms, keep current draw buffer", BSP_DRAW_BUF_FLUSH_TIMEOUT_MS);
+        free(buf1);
+        free(buf2);
+        free(bounce[0]);
+        free(bounce[1]);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    if (s_drv == NULL) {
+        // 替换esp_lvgl_port注册的回调：分条传输时只有最后一条完成才能通知LVGL
+        lcd_register_color_done(drawbuf_trans_done, NULL);
+    }
+    // esp_lvgl_port分配的初始缓冲区归它所有，保留不释放（它没有更换缓冲区的接口），这里只释放本模块分配的
+    free(s_buf[0]);
+    free(s_buf[1]);
+    free(s_bounce[0]);
+    free(s_bounce[1]);
+
+    s_panel = panel_handle;
+    s_io = io_handle;
+    s_drv = disp->driver;
+    s_cfg = *cfg;
+    s_buf[0] = buf1;
+    s_buf[1] = buf2;
+    s_bounce[0] = bounce[0];
+    s_bounce[1] = bounce[1];
+    s_bounce_idx = 0;
+    atomic_store(&s_pending, 0);
+    s_all_issued = false;
+    s_last_issued = false;
+
+    lv_disp_draw_buf_init(draw_buf, buf1, buf2, size);
+    disp->driver->flush_cb = (cfg->strategy == BSP_DRAW_BUF_PSRAM_BOUNCE) ? flush_bounce : flush_direct;
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+
+    ESP_LOGI(TAG, "Draw buffer: %s, %u lines, %u bytes internal", s_strategy_names[cfg->strategy],
+             cfg->lines, (unsigned)bsp_drawbuf_internal_bytes(cfg));
+    return ESP_OK;
+}
+
+// 参考画面：渐变背景、文字、按钮和圆弧，覆盖常见的填充、文字和抗锯齿绘制
+static lv_obj_t *create_reference_scene(void) {
+    lv_obj_t *scr = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(scr, lv_color_hex(0x102040), 0);
+    lv_obj_set_style_bg_grad_color(scr, lv_color_hex(0x40A080), 0);
+    lv_obj_set_style_bg_grad_dir(scr, LV_GRAD_DIR_VER, 0);
+
+    for (int i = 0; i < 6; i++) {
+        lv_obj_t *label = lv_label_create(scr);
+        lv_label_set_text(label, "[123] 12:00:00.000 [Q1] sensors/room/temp: {\"t\":23.5,\"h\":41}");
+        lv_obj_set_style_text_font(label, &lv_font_montserrat_12, 0);
+        lv_obj_set_width(label, BSP_LCD_H_RES - 20);
+        lv_obj_set_pos(label, 10, 10 + i * 18);
+    }
+    for (int i = 0; i < 3; i++) {
+        lv_obj_t *btn = lv_btn_create(scr);
+        lv_obj_set_size(btn, 80, 36);
+        lv_obj_set_pos(btn, 10 + i * 95, 130);
+    }
+    lv_obj_t *arc = lv_arc_create(scr);
+    lv_obj_set_size(arc, 60, 60);
+    lv_obj_set_pos(arc, 130, 172);
+    lv_arc_set_value(arc, 70);
+    return scr;
+}
+
+// 渲染若干整屏帧并返回平均每帧耗时，传输超时返回0
+static uint32_t measure_frames(lv_disp_t *disp, lv_obj_t *scene) {
+    // 预热一帧（字形缓存等）
+    lv_obj_invalidate(scene);
+    lv_refr_now(disp);
+    if (!bsp_drawbuf_wait_idle(disp, BSP_DRAW_BUF_FLUSH_TIMEOUT_MS)) {
+        return 0;
+    }
+
+    int64_t t0 = esp_timer_get_time();
+    for (int i = 0; i < BSP_DRAW_BUF_CALIB_FRAMES; i++) {
+        lv_obj_invalidate(scene);
+        lv_refr_now(disp);
+    }
+    if (!bsp_drawbuf_wait_idle(disp, BSP_DRAW_BUF_FLUSH_TIMEOUT_MS)) {
+        return 0;
+    }
+    return (uint32_t)((esp_timer_get_time() - t0) / BSP_DRAW_BUF_CALIB_FRAMES);
+}
+
+esp_err_t bsp_drawbuf_calibrate(lv_disp_t *disp, size_t budget, bsp_draw_buf_cfg_t *best) {
+    if (s_drv == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    bsp_draw_buf_cfg_t orig = s_cfg;
+    lv_obj_t *prev = lv_disp_get_scr_act(disp);
+    lv_obj_t *scene = create_reference_scene();
+    lv_disp_load_scr(scene);
+
+    best->frame_us = 0;
+    for (size_t i = 0; i < sizeof(s_candidates) / sizeof(s_candidates[0]); i++) {
+        bsp_draw_buf_cfg_t cand = s_candidates[i];
+        if (bsp_drawbuf_internal_bytes(&cand) > budget) {
+            continue;
+        }
+        if (bsp_drawbuf_apply(disp, s_panel, s_io, &cand) != ESP_OK) {
+            ESP_LOGW(TAG, "Skip %s/%u: allocation failed", s_strategy_names[cand.strategy], cand.lines);
+            continue;
+        }
+        cand.frame_us = measure_frames(disp, scene);
+        if (cand.frame_us == 0) {
+            ESP_LOGW(TAG, "Skip %s/%u: flush timed out", s_strategy_names[cand.strategy], cand.lines);
+            continue;
+        }
+        ESP_LOGI(TAG, "Calibrate %s/%u: %lu us/frame", s_strategy_names[cand.strategy], cand.lines,
+                 (unsigned long)cand.frame_us);
+        // 耗时相同时保留先出现的（内部RAM占用不更多的）配置
+        if (best->frame_us == 0 || cand.frame_us < best->frame_us) {
+            *best = cand;
+        }
+    }
+
+    lv_disp_load_scr(prev);
+    lv_obj_del(scene);
+
+    if (best->frame_us == 0) {
+        bsp_drawbuf_apply(disp, s_panel, s_io, &orig);
+        return ESP_ERR_NOT_FOUND;
+    }
+    return bsp_drawbuf_apply(disp, s_panel, s_io, best);
+}
+
+static esp_err_t drawbuf_load(bsp_draw_buf_cfg_t *cfg) {
+    nvs_handle_t nvs;
+    drawbuf_nvs_t blob;
+    size_t len = sizeof(blob);
+
+    esp_err_t ret = nvs_open(BSP_DRAW_BUF_NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_get_blob(nvs, BSP_DRAW_BUF_NVS_KEY, &blob, &len);
+    nvs_close(nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    if (len != sizeof(blob) || blob.version != CFG_VERSION) {
+        return ESP_ERR_INVALID_VERSION;
+    }
+    *cfg = blob.cfg;
+    return ESP_OK;
+}
+
+static esp_err_t drawbuf_save(const bsp_draw_buf_cfg_t *cfg) {
+    nvs_handle_t nvs;
+    drawbuf_nvs_t blob = {.version = CFG_VERSION, .cfg = *cfg};
+
+    esp_err_t ret = nvs_open(BSP_DRAW_BUF_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = nvs_set_blob(nvs, BSP_DRAW_BUF_NVS_KEY, &blob, sizeof(blob));
+    if (ret == ESP_OK) {
+        ret = nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+    return ret;
+}
+
+esp_err_t bsp_drawbuf_setup(lv_disp_t *disp, esp_lcd_panel_handle_t panel_handle,
+                            esp_lcd_panel_io_handle_t io_handle) {
+    bsp_draw_buf_cfg_t cfg;
+
+    if (!BSP_DRAW_BUF_FORCE_CALIBRATE && drawbuf_load(&cfg) == ESP_OK &&
+        bsp_drawbuf_internal_bytes(&cfg) <= BSP_DRAW_BUF_INTERNAL_BUDGET &&
+        bsp_drawbuf_apply(disp, panel_handle, io_handle, &cfg) == ESP_OK) {
+        return ESP_OK;
+    }
+
+    // 先切换到一个配置以接管flush回调，再逐个候选校准
+    const bsp_draw_buf_cfg_t legacy = {BSP_DRAW_BUF_PSRAM_SINGLE, BSP_LCD_DRAW_BUF_HEIGHT, 0};
+    ESP_RETURN_ON_ERROR(bsp_drawbuf_apply(disp, panel_handle, io_handle, &legacy), TAG, "Apply draw buffer failed");
+    ESP_RETURN_ON_ERROR(bsp_drawbuf_calibrate(disp, BSP_DRAW_BUF_INTERNAL_BUDGET, &cfg), TAG, "Calibration failed");
+    ESP_LOGI(TAG, "Selected %s/%u (%lu us/frame)", s_strategy_names[cfg.strategy], cfg.lines,
+             (unsigned long)cfg.frame_us);
+    if (drawbuf_save(&cfg) != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to save draw buffer calibration");
+    }
+    return ESP_OK;
+}
+
+const bsp_draw_buf_cfg_t *bsp_drawbuf_current(void) {
+    return &s_cfg;
+}
+
+const char *bsp_drawbuf_strategy_name(uint8_t strategy) {
+    return (strategy < BSP_DRAW_BUF_STRATEGY_MAX) ? s_strategy_names[strategy] : "unknown";
+}
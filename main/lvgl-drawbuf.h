@@ -0,0 +1,119 @@
+#ifndef LVGL_DRAWBUF_H
+#define LVGL_DRAWBUF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "lvgl.h"
+
+/**
+ * @defgroup DRAWBUF_CONFIG LVGL绘图缓冲区配置
+ * @{
+ */
+#define BSP_DRAW_BUF_INTERNAL_BUDGET  (64 * 1024)  ///< 绘图缓冲区可占用的内部RAM上限（字节）
+#define BSP_DRAW_BUF_BOUNCE_LINES     10           ///< PSRAM+中转策略中每块内部中转缓冲区的行数
+#define BSP_DRAW_BUF_CALIB_FRAMES     6            ///< 校准时每个候选方案渲染的整屏帧数
+#define BSP_DRAW_BUF_FORCE_CALIBRATE  0            ///< 置1时每次启动都重新校准（忽略NVS中的结果）
+#define BSP_DRAW_BUF_NVS_NAMESPACE    "display"    ///< 校准结果保存的NVS命名空间
+#define BSP_DRAW_BUF_NVS_KEY          "drawbuf"    ///< 校准结果保存的NVS键
+#define BSP_DRAW_BUF_FLUSH_TIMEOUT_MS 500          ///< 等待传输结束的超时（毫秒）
+/** @} */
+
+/**
+ * @brief 绘图缓冲区策略
+ */
+typedef enum {
+    BSP_DRAW_BUF_PSRAM_SINGLE = 0,  ///< PSRAM单缓冲（SPI驱动每次传输前临时拷贝到DMA内存）
+    BSP_DRAW_BUF_DMA_SINGLE,        ///< 内部DMA内存单缓冲
+    BSP_DRAW_BUF_DMA_DOUBLE,        ///< 内部DMA内存双缓冲（渲染与SPI传输并行）
+    BSP_DRAW_BUF_PSRAM_BOUNCE,      ///< PSRAM双缓冲，经两块内部DMA中转缓冲区分条传输
+    BSP_DRAW_BUF_STRATEGY_MAX,
+} bsp_draw_buf_strategy_t;
+
+/**
+ * @brief 绘图缓冲区配置
+ */
+typedef struct {
+    uint8_t strategy;   ///< bsp_draw_buf_strategy_t
+    uint16_t lines;     ///< LVGL绘图缓冲区行数（每块）
+    uint32_t frame_us;  ///< 校准测得的整屏渲染+传输耗时（微秒），未校准为0
+} bsp_draw_buf_cfg_t;
+
+/**
+ * @brief 计算某个配置占用的内部RAM（字节）
+ */
+size_t bsp_drawbuf_internal_bytes(const bsp_draw_buf_cfg_t *cfg);
+
+/**
+ * @brief 把显示切换到指定的缓冲区配置（替换esp_lvgl_port的缓冲区和flush回调）
+ * @note 需持有LVGL锁。新缓冲区分配失败或等待传输超时时保持原配置不变。
+ *       esp_lvgl_port 1.4没有重新配置缓冲区的接口，它在lvgl_port_add_disp时分配的初始缓冲区保留不释放，
+ *       因此初始缓冲区应尽量小（BSP_LCD_DRAW_BUF_HEIGHT）
+ * @param disp LVGL显示
+ * @param panel_handle LCD面板句柄
+ * @param io_handle LCD IO句柄
+ * @param cfg 缓冲区配置
+ * @return ESP_OK成功，ESP_ERR_NO_MEM内存不足，ESP_ERR_INVALID_ARG配置非法，ESP_ERR_TIMEOUT等待传输超时
+ */
+esp_err_t bsp_drawbuf_apply(lv_disp_t *disp, esp_lcd_panel_handle_t panel_handle,
+                            esp_lcd_panel_io_handle_t io_handle, const bsp_draw_buf_cfg_t *cfg);
+
+/**
+ * @brief 校准：依次应用内部RAM预算内的每个候选配置，渲染参考画面并计时，选出最快的一个
+ * @note 需持有LVGL锁，且须先调用过bsp_drawbuf_apply（用于确定面板和IO句柄）。
+ *       校准结束后显示保持在最快的配置上。
+ * @param disp LVGL显示
+ * @param budget 内部RAM预算（字节）
+ * @param[out] best 最快的配置
+ * @return ESP_OK成功，ESP_ERR_NOT_FOUND没有可用的候选配置
+ */
+esp_err_t bsp_drawbuf_calibrate(lv_disp_t *disp, size_t budget, bsp_draw_buf_cfg_t *best);
+
+/**
+ * @brief 启动时配置绘图缓冲区：优先使用NVS中保存的校准结果，没有则校准并保存
+ * @note 需持有LVGL锁
+ * @param disp LVGL显示
+ * @param panel_handle LCD面板句柄
+ * @param io_handle LCD IO句柄
+ * @return ESP_OK成功
+ */
+esp_err_t bsp_drawbuf_setup(lv_disp_t *disp, esp_lcd_panel_handle_t panel_handle,
+                            esp_lcd_panel_io_handle_t io_handle);
+
+/**
+ * @brief 等待正在进行的传输结束（等待传输完成中断的信号，不忙等）
+ * @note 持有或不持有LVGL锁均可调用
+ * @param disp LVGL显示
+ * @param timeout_ms 超时（毫秒）
+ * @return true传输已结束，false超时
+ */
+bool bsp_drawbuf_wait_idle(lv_disp_t *disp, uint32_t timeout_ms);
+
+/**
+ * @brief 获取已传输完成的帧数（一帧的最后一个区域传输完成时加1）
+ */
+uint32_t bsp_drawbuf_frame_count(void);
+
+/**
+ * @brief 等待一帧传输完成
+ * @note 不能持有LVGL锁（LVGL任务需要渲染这一帧）
+ * @param since 开始等待前bsp_drawbuf_frame_count的返回值
+ * @param timeout_ms 超时（毫秒）
+ * @return true帧数已变化，false超时或尚未调用过bsp_drawbuf_apply
+ */
+bool bsp_drawbuf_wait_frame(uint32_t since, uint32_t timeout_ms);
+
+/**
+ * @brief 获取当前生效的配置
+ */
+const bsp_draw_buf_cfg_t *bsp_drawbuf_current(void);
+
+/**
+ * @brief 获取策略名称（用于日志和报告）
+ */
+const char *bsp_drawbuf_strategy_name(uint8_t strategy);
+
+#endif  // !LVGL_DRAWBUF_H
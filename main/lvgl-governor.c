@@ -0,0 +1,115 @@
+#include "lvgl-governor.h"
+
+#include "esp_log.h"
+#include "esp_lvgl_port.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lcd.h"
+#include "lvgl-components.h"
+#include "lvgl-drawbuf.h"
+
+static const char *TAG = "lvgl_gov";
+
+static lv_disp_t *s_disp = NULL;
+static lv_indev_t *s_indev = NULL;
+static TaskHandle_t s_task = NULL;
+static volatile bsp_gov_state_t s_state = BSP_GOV_ACTIVE;
+
+static const char *s_state_names[] = {"active", "static", "dim", "off"};
+
+static void suspend_render(void) {
+    bsp_display_brightness_set(0);
+    lvgl_port_lock(0);
+    lvgl_port_stop();
+    lvgl_port_unlock();
+}
+
+// 恢复渲染：先在关闭背光的状态下由LVGL任务重绘一整帧，传输完成后再打开背光，避免露出过时的画面
+static void resume_render(void) {
+    lvgl_port_resume();
+    lvgl_port_lock(0);
+    lv_disp_trig_activity(s_disp);  // 暂停期间tick停止，不重置会立即再次暂停
+    lv_indev_wait_release(s_indev);  // 唤醒屏幕的这次按压不触发点击
+    lv_timer_resume(s_indev->driver->read_timer);  // 空闲时读取定时器可能已暂停，需要读到这次松开
+    lv_timer_set_period(s_disp->refr_timer, LV_DISP_DEF_REFR_PERIOD);
+    uint32_t frame = bsp_drawbuf_frame_count();
+    lv_obj_invalidate(lv_disp_get_scr_act(s_disp));
+    lvgl_port_unlock();
+    bsp_lvgl_wake();  // 渲染在LVGL任务中进行，本任务栈不够执行lv_timer_handler
+    if (!bsp_drawbuf_wait_frame(frame, BSP_GOV_RESUME_MS)) {
+        ESP_LOGW(TAG, "No frame within %d ms after resume", BSP_GOV_RESUME_MS);
+    }
+    bsp_display_brightness_set(BSP_GOV_ACTIVE_PCT);
+}
+
+static void apply_state(bsp_gov_state_t state) {
+    bsp_gov_state_t prev = s_state;
+
+    if (prev == BSP_GOV_OFF) {
+        resume_render();
+    }
+    if (state == BSP_GOV_OFF) {
+        suspend_render();
+    } else {
+        lvgl_port_lock(0);
+        lv_timer_set_period(s_disp->refr_timer,
+                            state == BSP_GOV_ACTIVE ? LV_DISP_DEF_REFR_PERIOD : BSP_GOV_STATIC_REFR_MS);
+        lvgl_port_unlock();
+        if (state == BSP_GOV_DIM) {
+            bsp_display_brightness_set(BSP_GOV_DIM_PCT);
+        } else if (prev == BSP_GOV_DIM) {
+            bsp_display_brightness_set(BSP_GOV_ACTIVE_PCT);
+        }
+    }
+    s_state = state;
+    ESP_LOGI(TAG, "%s -> %s", s_state_names[prev], s_state_names[state]);
+}
+
+static void governor_task(void *arg) {
+    while (1) {
+        // 触摸只由触摸唤醒任务读取（渲染暂停期间也是），检测到按压时通知本任务
+        bool touched = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BSP_GOV_POLL_MS)) > 0;
+
+        if (s_state == BSP_GOV_OFF) {
+            if (touched) {
+                apply_state(BSP_GOV_ACTIVE);
+            }
+            continue;
+        }
+
+        lvgl_port_lock(0);
+        uint32_t idle = lv_disp_get_inactive_time(s_disp);
+        lvgl_port_unlock();
+
+        bsp_gov_state_t target = BSP_GOV_ACTIVE;
+        if (idle >= BSP_GOV_OFF_MS) {
+            target = BSP_GOV_OFF;
+        } else if (idle >= BSP_GOV_DIM_MS) {
+            target = BSP_GOV_DIM;
+        } else if (idle >= BSP_GOV_STATIC_MS) {
+            target = BSP_GOV_STATIC;
+        }
+        if (target != s_state) {
+            apply_state(target);
+        }
+    }
+}
+
+esp_err_t bsp_governor_init(lv_disp_t *disp, lv_indev_t *indev) {
+    s_disp = disp;
+    s_indev = indev;
+    if (xTaskCreate(governor_task, "lvgl_gov", BSP_GOV_TASK_STACK, NULL, BSP_GOV_TASK_PRIORITY, &s_task) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void bsp_governor_kick(void) {
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+}
+
+bsp_gov_state_t bsp_governor_state(void) {
+    return s_state;
+}
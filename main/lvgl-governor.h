@@ -0,0 +1,53 @@
+#ifndef LVGL_GOVERNOR_H
+#define LVGL_GOVERNOR_H
+
+#include "esp_err.h"
+#include "lvgl.h"
+
+/**
+ * @defgroup GOVERNOR_CONFIG 显示活动调节配置
+ * @note 时间均为距最后一次触摸的时长
+ * @{
+ */
+#define BSP_GOV_STATIC_MS      5000    ///< 超过此时间视为静止：降低最大刷新率
+#define BSP_GOV_DIM_MS         30000   ///< 超过此时间调暗背光
+#define BSP_GOV_OFF_MS         120000  ///< 超过此时间关闭背光并暂停渲染
+#define BSP_GOV_STATIC_REFR_MS 100     ///< 静止时的刷新周期（最高10帧/秒）
+#define BSP_GOV_ACTIVE_PCT     50      ///< 正常背光亮度（%）
+#define BSP_GOV_DIM_PCT        10      ///< 调暗后的背光亮度（%）
+#define BSP_GOV_POLL_MS        200     ///< 调节任务检查周期
+#define BSP_GOV_RESUME_MS      300     ///< 恢复渲染时等待第一帧传输完成的最长时间，超时也打开背光
+#define BSP_GOV_TASK_STACK     3072    ///< 调节任务栈大小
+#define BSP_GOV_TASK_PRIORITY  3       ///< 调节任务优先级（低于LVGL任务）
+/** @} */
+
+/**
+ * @brief 显示活动状态
+ */
+typedef enum {
+    BSP_GOV_ACTIVE = 0,  ///< 正常刷新率、正常亮度
+    BSP_GOV_STATIC,      ///< 降低刷新率
+    BSP_GOV_DIM,         ///< 降低刷新率、调暗背光
+    BSP_GOV_OFF,         ///< 背光关闭、渲染暂停（消息接收和日志照常）
+} bsp_gov_state_t;
+
+/**
+ * @brief 启动显示活动调节任务
+ * @note 在bsp_lvgl_start中触摸初始化之后调用，调用时不能持有LVGL锁
+ * @param disp LVGL显示
+ * @param indev 触摸输入设备（恢复时忽略唤醒屏幕的这次按压）
+ * @return ESP_OK成功
+ */
+esp_err_t bsp_governor_init(lv_disp_t *disp, lv_indev_t *indev);
+
+/**
+ * @brief 通知调节任务有触摸（由触摸唤醒任务调用），渲染暂停时立即恢复
+ */
+void bsp_governor_kick(void);
+
+/**
+ * @brief 获取当前状态
+ */
+bsp_gov_state_t bsp_governor_state(void);
+
+#endif  // !LVGL_GOVERNOR_H
@@ -0,0 +1,227 @@
+#include "lvgl-perf.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+
+static const char *TAG = "lvgl_perf";
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// 采样环（s_head为下一个写入位置）
+static bsp_perf_sample_t s_ring[BSP_PERF_RING_SIZE];
+static size_t s_head = 0;
+static size_t s_count = 0;
+
+// 当前帧的累计值，只在LVGL任务中修改（dma_us除外）
+static bsp_perf_sample_t s_acc;
+static int64_t s_frame_start = 0;
+static int64_t s_submit_start = 0;
+static int64_t s_wait_start = 0;
+static bool s_waiting = false;
+
+// 传输完成中断使用的状态
+static volatile int64_t s_submit_end = 0;
+static volatile int64_t s_last_done = 0;
+static bsp_perf_sample_t *volatile s_dma_target = &s_acc;  // 传输完成耗时累加到的采样
+
+static lv_disp_t *s_disp = NULL;
+static void (*s_monitor_chain)(lv_disp_drv_t *, uint32_t, uint32_t) = NULL;  // 被替换的monitor_cb
+static uint32_t s_frames = 0;  // 启动以来的帧数
+static uint32_t s_fps = 0;
+static lv_obj_t *s_overlay = NULL;
+
+// 结束一次阻塞等待：优先使用中断记录的完成时刻，竞争时退化为当前时刻
+static void close_wait(int64_t now) {
+    if (!s_waiting) {
+        return;
+    }
+    int64_t end = (s_last_done > s_wait_start) ? s_last_done : now;
+    s_acc.wait_us += (uint32_t)(end - s_wait_start);
+    s_waiting = false;
+}
+
+static void perf_render_start_cb(lv_disp_drv_t *drv) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_acc, 0, sizeof(s_acc));
+    s_dma_target = &s_acc;
+    portEXIT_CRITICAL(&s_lock);
+    s_waiting = false;
+    s_frame_start = now;
+}
+
+static void perf_wait_cb(lv_disp_drv_t *drv) {
+    if (!s_waiting) {
+        s_wait_start = esp_timer_get_time();
+        s_waiting = true;
+    }
+}
+
+static void perf_monitor_cb(lv_disp_drv_t *drv, uint32_t time, uint32_t px) {
+    int64_t now = esp_timer_get_time();
+
+    close_wait(now);
+    s_acc.frame_us = (uint32_t)(now - s_frame_start);
+    uint32_t spent = s_acc.submit_us + s_acc.wait_us;
+    s_acc.render_us = (s_acc.frame_us > spent) ? s_acc.frame_us - spent : 0;
+
+    portENTER_CRITICAL(&s_lock);
+    bsp_perf_sample_t *slot = &s_ring[s_head];
+    *slot = s_acc;
+    // 最后一个区域仍在传输时，其完成耗时记入刚提交的采样
+    s_dma_target = drv->draw_buf->flushing ? slot : &s_acc;
+    s_head = (s_head + 1) % BSP_PERF_RING_SIZE;
+    if (s_count < BSP_PERF_RING_SIZE) {
+        s_count++;
+    }
+    s_frames++;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_monitor_chain != NULL) {
+        s_monitor_chain(drv, time, px);
+    }
+}
+
+void bsp_perf_flush_begin(const lv_area_t *area) {
+    int64_t now = esp_timer_get_time();
+
+    close_wait(now);
+    s_submit_start = now;
+    s_acc.areas++;
+    s_acc.px += lv_area_get_size(area);
+}
+
+void bsp_perf_flush_end(void) {
+    int64_t now = esp_timer_get_time();
+
+    s_acc.submit_us += (uint32_t)(now - s_submit_start);
+    s_submit_end = now;
+}
+
+void IRAM_ATTR bsp_perf_flush_done_isr(void) {
+    int64_t now = esp_timer_get_time();
+    // 中转分条传输时最后一条可能在flush_end之前完成
+    int64_t ref = (s_submit_end > s_submit_start) ? s_submit_end : s_submit_start;
+
+    portENTER_CRITICAL_ISR(&s_lock);
+    if (now > ref) {
+        s_dma_target->dma_us += (uint32_t)(now - ref);
+    }
+    s_last_done = now;
+    portEXIT_CRITICAL_ISR(&s_lock);
+}
+
+size_t bsp_perf_get_samples(bsp_perf_sample_t *out, size_t max) {
+    portENTER_CRITICAL(&s_lock);
+    size_t n = (s_count < max) ? s_count : max;
+    size_t start = (s_head + BSP_PERF_RING_SIZE - n) % BSP_PERF_RING_SIZE;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = s_ring[(start + i) % BSP_PERF_RING_SIZE];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void bsp_perf_get_summary(bsp_perf_summary_t *summary) {
+    static bsp_perf_sample_t samples[BSP_PERF_RING_SIZE];
+    uint64_t frame = 0, render = 0, submit = 0, wait = 0, dma = 0, areas = 0, px = 0;
+
+    memset(summary, 0, sizeof(*summary));
+    size_t n = bsp_perf_get_samples(samples, BSP_PERF_RING_SIZE);
+    for (size_t i = 0; i < n; i++) {
+        frame += samples[i].frame_us;
+        render += samples[i].render_us;
+        submit += samples[i].submit_us;
+        wait += samples[i].wait_us;
+        dma += samples[i].dma_us;
+        areas += samples[i].areas;
+        px += samples[i].px;
+        if (samples[i].frame_us > summary->max_frame_us) {
+            summary->max_frame_us = samples[i].frame_us;
+        }
+    }
+    summary->samples = n;
+    summary->frames = s_frames;
+    summary->fps = s_fps;
+    summary->cpu = 100 - lv_timer_get_idle();
+    if (n > 0) {
+        summary->avg_frame_us = frame / n;
+        summary->avg_render_us = render / n;
+        summary->avg_submit_us = submit / n;
+        summary->avg_wait_us = wait / n;
+        summary->avg_dma_us = dma / n;
+        summary->avg_areas = areas / n;
+        summary->avg_px = px / n;
+    }
+}
+
+void bsp_perf_reset(void) {
+    portENTER_CRITICAL(&s_lock);
+    s_head = 0;
+    s_count = 0;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// 微秒转为"x.y"毫秒
+static void fmt_ms(char *buf, size_t size, uint32_t us) {
+    snprintf(buf, size, "%lu.%lu", (unsigned long)(us / 1000), (unsigned long)(us % 1000 / 100));
+}
+
+static void perf_timer_cb(lv_timer_t *timer) {
+    static uint32_t last_frames = 0;
+    bsp_perf_summary_t sum;
+    char r[12], s[12], w[12], d[12];
+
+    s_fps = (s_frames - last_frames) * 1000 / BSP_PERF_OVERLAY_PERIOD_MS;
+    last_frames = s_frames;
+    if (s_overlay == NULL) {
+        return;
+    }
+
+    bsp_perf_get_summary(&sum);
+    fmt_ms(r, sizeof(r), sum.avg_render_us);
+    fmt_ms(s, sizeof(s), sum.avg_submit_us);
+    fmt_ms(w, sizeof(w), sum.avg_wait_us);
+    fmt_ms(d, sizeof(d), sum.avg_dma_us);
+    lv_label_set_text_fmt(s_overlay, "%lu FPS  CPU %u%%\nR %s S %s W %s D %s",
+                          (unsigned long)sum.fps, sum.cpu, r, s, w, d);
+}
+
+void bsp_perf_overlay_show(bool show) {
+    if (show && s_overlay == NULL) {
+        s_overlay = lv_label_create(lv_layer_top());
+        lv_obj_set_style_text_font(s_overlay, &lv_font_montserrat_12, 0);
+        lv_obj_set_style_text_color(s_overlay, lv_color_white(), 0);
+        lv_obj_set_style_bg_color(s_overlay, lv_color_black(), 0);
+        lv_obj_set_style_bg_opa(s_overlay, LV_OPA_60, 0);
+        lv_obj_set_style_pad_all(s_overlay, 2, 0);
+        lv_obj_clear_flag(s_overlay, LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_align(s_overlay, LV_ALIGN_TOP_RIGHT, 0, 0);
+        lv_label_set_text(s_overlay, "-- FPS");
+    } else if (!show && s_overlay != NULL) {
+        lv_obj_del(s_overlay);
+        s_overlay = NULL;
+    }
+}
+
+void bsp_perf_init(lv_disp_t *disp) {
+    if (disp->driver->monitor_cb != perf_monitor_cb) {
+        s_monitor_chain = disp->driver->monitor_cb;
+    }
+    disp->driver->render_start_cb = perf_render_start_cb;
+    disp->driver->wait_cb = perf_wait_cb;
+    disp->driver->monitor_cb = perf_monitor_cb;
+    if (s_disp != NULL) {
+        return;
+    }
+    s_disp = disp;
+    lv_timer_create(perf_timer_cb, BSP_PERF_OVERLAY_PERIOD_MS, NULL);
+    bsp_perf_overlay_show(BSP_PERF_OVERLAY);
+    ESP_LOGI(TAG, "Frame timing enabled (%d samples)", BSP_PERF_RING_SIZE);
+}
@@ -0,0 +1,99 @@
+#ifndef LVGL_PERF_H
+#define LVGL_PERF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+
+/**
+ * @defgroup PERF_CONFIG 渲染/传输计时配置
+ * @{
+ */
+#define BSP_PERF_RING_SIZE         64    ///< 保留的最近帧采样数
+#define BSP_PERF_OVERLAY           0     ///< 置1时启动后默认显示性能浮层
+#define BSP_PERF_OVERLAY_PERIOD_MS 1000  ///< 浮层刷新周期（毫秒）
+/** @} */
+
+/**
+ * @brief 单帧（一次LVGL刷新）计时采样
+ *
+ * frame_us = render_us + submit_us + wait_us。dma_us是各区域从提交完成到
+ * SPI传输完成的时间之和，与渲染并行的部分不计入wait_us。
+ */
+typedef struct {
+    uint32_t frame_us;   ///< 整帧耗时（开始渲染到最后一个区域提交完成）
+    uint32_t render_us;  ///< 渲染耗时（整帧耗时减去提交和等待）
+    uint32_t submit_us;  ///< flush回调中提交传输的耗时（含中转拷贝）
+    uint32_t wait_us;    ///< LVGL阻塞等待传输完成的耗时
+    uint32_t dma_us;     ///< 传输完成耗时之和（提交完成到传输完成中断）
+    uint32_t px;         ///< 刷新的像素数
+    uint16_t areas;      ///< flush的区域数
+} bsp_perf_sample_t;
+
+/**
+ * @brief 最近采样的统计
+ */
+typedef struct {
+    uint32_t samples;        ///< 参与统计的帧数
+    uint32_t frames;         ///< 启动以来的总帧数
+    uint32_t fps;            ///< 最近一个统计周期（BSP_PERF_OVERLAY_PERIOD_MS）内的帧率
+    uint8_t cpu;             ///< LVGL任务CPU占用（%）
+    uint32_t avg_frame_us;   ///< 平均整帧耗时
+    uint32_t max_frame_us;   ///< 最大整帧耗时
+    uint32_t avg_render_us;  ///< 平均渲染耗时
+    uint32_t avg_submit_us;  ///< 平均提交耗时
+    uint32_t avg_wait_us;    ///< 平均等待耗时
+    uint32_t avg_dma_us;     ///< 平均传输完成耗时
+    uint32_t avg_areas;      ///< 平均每帧区域数
+    uint32_t avg_px;         ///< 平均每帧像素数
+} bsp_perf_summary_t;
+
+/**
+ * @brief 在显示驱动上安装计时回调（render_start_cb/wait_cb/monitor_cb）
+ * @note 需持有LVGL锁。其他模块（如LVGL基准测试）替换了monitor_cb后可再次调用，
+ *       计时回调会重新安装并在每帧结束时转调被替换的monitor_cb
+ * @param disp LVGL显示
+ */
+void bsp_perf_init(lv_disp_t *disp);
+
+/**
+ * @brief flush回调开始提交一个区域时调用
+ */
+void bsp_perf_flush_begin(const lv_area_t *area);
+
+/**
+ * @brief flush回调提交完一个区域时调用
+ */
+void bsp_perf_flush_end(void);
+
+/**
+ * @brief 区域传输完成时调用（中断上下文）
+ */
+void bsp_perf_flush_done_isr(void);
+
+/**
+ * @brief 读取最近的采样（从旧到新）
+ * @param[out] out 输出数组
+ * @param max 数组容量
+ * @return 实际读取的采样数
+ */
+size_t bsp_perf_get_samples(bsp_perf_sample_t *out, size_t max);
+
+/**
+ * @brief 统计最近的采样
+ */
+void bsp_perf_get_summary(bsp_perf_summary_t *summary);
+
+/**
+ * @brief 清空采样
+ */
+void bsp_perf_reset(void);
+
+/**
+ * @brief 显示或隐藏性能浮层（FPS、CPU%和各阶段平均耗时）
+ * @note 需持有LVGL锁
+ */
+void bsp_perf_overlay_show(bool show);
+
+#endif  // !LVGL_PERF_H
@@ -1,11 +1,16 @@
 #include <stdio.h>
 #include "lcd.h"
 #include "lvgl-components.h"
-#include "ui.h"
+#include "lvgl-bench.h"
+#include "core-load.h"
+#include "boot-graph.h"
+#include "ui_app.h"
 #include "lvgl.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "wifi_setting.h"
+#include "nvs_flash.h"
 #include "mqtt_tool.h"
 #include "main_update.h"
 
@@ -14,6 +19,7 @@
 #include "task_communication.h"
 #include "ui_interface.h"
 #include "mqtt_message_display.h"
+#include "mqtt_message_journal.h"
 
 static const char *TAG = "main";
 
@@ -31,57 +37,165 @@ static TaskHandle_t gui_task_handle = NULL;           ///< GUI任务句柄
 static TaskHandle_t main_logic_task_handle = NULL;    ///< 主逻辑任务句柄
 
 
-void hardware_init_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Starting hardware initialization...");
-
-    // 硬件初始化
-    bsp_i2c_init();                                    ///< 初始化I2C接口
+/**
+ * @defgroup BOOT_STAGES 启动步骤
+ * @brief Wi-Fi连接与显示、界面的初始化互不依赖，并行执行，Wi-Fi连接期间界面已经可以显示
+ * @{
+ */
+enum {
+    STAGE_I2C,
+    STAGE_PCA9557,
+    STAGE_NVS,
+    STAGE_WIFI,
+    STAGE_QUEUES,
+    STAGE_LVGL,
+#if !LV_USE_DEMO_BENCHMARK
+    STAGE_JOURNAL,
+    STAGE_UI,
+    STAGE_DISPLAY,
+    STAGE_GUI_TASK,
+    STAGE_LOGIC_TASK,
+#endif
+};
+
+static esp_err_t stage_pca9557(void) {
     pca9557_init();                                    ///< 初始化PCA9557 IO扩展芯片
-    wifi_init();                                       ///< 初始化WiFi连接
-    bsp_lvgl_start(&io_handle, &panel_handle);         ///< 启动LVGL显示系统
+    return ESP_OK;
+}
 
-    // 初始化UI
-    ui_init();                                         ///< 初始化UI界面
-    mqtt_display_init(ui_reviceMsg,ui_MsgNum,ui_MqttState);                               ///< 初始化MQTT消息显示管理器
-    mqtt_display_add_system_msg("System initialized", "info");  ///< 添加系统初始化消息到显示管理器
+static esp_err_t stage_nvs(void) {
+    // 绘制缓冲区配置和Wi-Fi快速重连缓存保存在NVS中，Wi-Fi驱动本身也需要NVS
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    return ret;
+}
 
-    ESP_LOGI(TAG, "Hardware initialization completed successfully.");
+static esp_err_t stage_wifi(void) {
+    wifi_init();                                       ///< 初始化WiFi连接（阻塞到连接成功或失败）
+    return ESP_OK;
+}
 
+static esp_err_t stage_queues(void) {
     ui_to_logic_queue = xQueueCreate(10, sizeof(ui_to_logic_msg_t));  ///< 创建UI到主逻辑任务的消息队列
     if (ui_to_logic_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create UI to logic queue");
-        vQueueDelete(ui_to_logic_queue);
-        vTaskDelete(NULL);                            ///< 删除当前任务
+        return ESP_ERR_NO_MEM;
     }
     logic_to_ui_queue = xQueueCreate(10, sizeof(logic_to_ui_msg_t));  ///< 创建主逻辑任务到UI的消息队列
     if (logic_to_ui_queue == NULL) {
         ESP_LOGE(TAG, "Failed to create logic to UI queue");
-        vQueueDelete(logic_to_ui_queue);              ///< 删除主逻辑任务到UI的消息队列
-        vTaskDelete(NULL);                            ///< 删除当前任务
+        return ESP_ERR_NO_MEM;
     }
+    return ESP_OK;
+}
 
-        // 创建GUI任务（高优先级，保证界面响应性）
-    xTaskCreate(
-        gui_task,           // 任务函数
-        "GUI_Task",         // 任务名称
-        8192,               // 栈大小（GUI可能需要更大的栈）
-        NULL,               // 参数
-        6,                  // 高优先级
-        &gui_task_handle    // 任务句柄
-    );
-    
-    // 创建主逻辑任务（中等优先级）
-    xTaskCreate(
-        main_logic_task,         // 任务函数
-        "Main_Logic_Task",       // 任务名称
-        4096,                    // 栈大小
-        NULL,                    // 参数
-        4,                       // 中等优先级
-        &main_logic_task_handle  // 任务句柄
-    );
-    
+static esp_err_t stage_lvgl(void) {
+    bsp_lvgl_start(&io_handle, &panel_handle);         ///< 启动LVGL显示系统
+#if LV_USE_DEMO_BENCHMARK
+    // 基准测试构建（sdkconfig.bench）：只运行基准测试，不启动正常界面和任务
+    bsp_bench_run(lv_disp_get_default());
+#endif
+    return ESP_OK;
+}
+
+#if !LV_USE_DEMO_BENCHMARK
+static esp_err_t stage_journal(void) {
+    // 挂载SPIFFS（必要时格式化）并扫描日志分段，耗时较长，不能放在LVGL锁内
+    if (!journal_init()) {
+        ESP_LOGW(TAG, "Message journal unavailable, history will not persist");
+    }
+    return ESP_OK;                                     ///< 日志不可用时界面照常启动
+}
+
+static esp_err_t stage_ui(void) {
+    // 初始化UI（LVGL任务已在运行，需要持有LVGL锁），不等待日志分区，尽快绘制第一帧
+    lvgl_port_lock(0);
+    ui_app_init();                                     ///< 初始化UI界面（只创建主界面，其他界面在后台分片创建）
+    lv_refr_now(NULL);                                 ///< 立即绘制第一帧
+    ESP_LOGI(TAG, "First frame at %lld ms", esp_timer_get_time() / 1000);
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t stage_display(void) {
+    // 日志就绪后再接管消息区（此前显示占位文字，界面事件调用的显示接口为空操作）
+    lvgl_port_lock(0);
+    mqtt_display_init(ui_reviceMsg,ui_MsgNum,ui_MqttState);                               ///< 初始化MQTT消息显示管理器
+    mqtt_display_add_system_msg("System initialized", "info");  ///< 添加系统初始化消息到显示管理器
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t stage_gui_task(void) {
+    // 创建GUI任务（高优先级，保证界面响应性）
+    if (xTaskCreatePinnedToCore(
+            gui_task,           // 任务函数
+            "GUI_Task",         // 任务名称
+            8192,               // 栈大小（GUI可能需要更大的栈）
+            NULL,               // 参数
+            6,                  // 高优先级
+            &gui_task_handle,   // 任务句柄
+            APP_CORE_GUI        // 与LVGL任务同核心
+        ) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stage_logic_task(void) {
+    // 创建主逻辑任务（中等优先级），Wi-Fi连接后才启动，之前的连接请求在队列中等待
+    if (xTaskCreatePinnedToCore(
+            main_logic_task,         // 任务函数
+            "Main_Logic_Task",       // 任务名称
+            4096,                    // 栈大小
+            NULL,                    // 参数
+            4,                       // 中等优先级
+            &main_logic_task_handle, // 任务句柄
+            APP_CORE_LOGIC           // 与网络栈同核心
+        ) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+#endif
+
+static const boot_stage_t boot_stages[] = {
+    [STAGE_I2C]        = {"i2c",     bsp_i2c_init,     0,                                    0,    tskNO_AFFINITY},
+    [STAGE_PCA9557]    = {"pca9557", stage_pca9557,    BOOT_DEP(STAGE_I2C),                  0,    tskNO_AFFINITY},
+    [STAGE_NVS]        = {"nvs",     stage_nvs,        0,                                    0,    tskNO_AFFINITY},
+    [STAGE_WIFI]       = {"wifi",    stage_wifi,       BOOT_DEP(STAGE_NVS),                  4096, APP_CORE_NET},
+    [STAGE_QUEUES]     = {"queues",  stage_queues,     0,                                    0,    tskNO_AFFINITY},
+    [STAGE_LVGL]       = {"lvgl",    stage_lvgl,       BOOT_DEP(STAGE_PCA9557) | BOOT_DEP(STAGE_NVS),
+                          0, APP_CORE_LVGL},
+#if !LV_USE_DEMO_BENCHMARK
+    [STAGE_JOURNAL]    = {"journal", stage_journal,    0,                                    0,    tskNO_AFFINITY},
+    [STAGE_UI]         = {"ui",      stage_ui,         BOOT_DEP(STAGE_LVGL) | BOOT_DEP(STAGE_QUEUES),
+                          0, APP_CORE_GUI},
+    [STAGE_DISPLAY]    = {"display", stage_display,    BOOT_DEP(STAGE_UI) | BOOT_DEP(STAGE_JOURNAL),
+                          0, APP_CORE_GUI},
+    [STAGE_GUI_TASK]   = {"gui",     stage_gui_task,   BOOT_DEP(STAGE_DISPLAY),              0,    tskNO_AFFINITY},
+    [STAGE_LOGIC_TASK] = {"logic",   stage_logic_task, BOOT_DEP(STAGE_WIFI) | BOOT_DEP(STAGE_QUEUES),
+                          0, tskNO_AFFINITY},
+#endif
+};
+/** @} */
+
+void hardware_init_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Starting hardware initialization...");
+
+    if (boot_graph_run(boot_stages, sizeof(boot_stages) / sizeof(boot_stages[0])) != ESP_OK) {
+        ESP_LOGE(TAG, "Hardware initialization incomplete");
+        vTaskDelete(NULL);
+    }
+    ESP_LOGI(TAG, "Hardware initialization completed successfully.");
+
+#if !LV_USE_DEMO_BENCHMARK
     ESP_LOGI(TAG, "所有任务创建完成");
-    
+    core_load_start();                                ///< 启动核心负载监测
+#endif
 
     // 任务完成后删除自身
     vTaskDelete(NULL);                                ///< 删除当前任务
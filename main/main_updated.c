@@ -8,6 +8,7 @@
 #include "freertos/task.h"
 
 #include "lvgl.h"
+#include "esp_lvgl_port.h"
 
 #include "task_communication.h"
 #include "ui_interface.h"
@@ -16,6 +17,7 @@
 #include "ui.h"
 
 #include "mqtt_message_display.h"
+#include "lvgl-components.h"
 
 // 日志标签
 static const char* TAG = "MAIN_UPDATED";
@@ -37,20 +39,26 @@ void gui_task(void* pvParameters) {
         case LOGIC_MSG_MQTT_STATUS:  // MQTT连接状态消息
           break;
         case LOGIC_MSG_MQTT_RECEIVED:  // 接收到的MQTT消息
-          ESP_LOGI(TAG, "Received MQTT message");
-          ESP_LOGI(TAG, "Topic: %s", rec_msg.data.mqtt_received.topic);
-          ESP_LOGI(TAG, "Payload: %s", rec_msg.data.mqtt_received.payload);
-          mqtt_display_add_message(rec_msg.data.mqtt_received.topic,
-                                    rec_msg.data.mqtt_received.payload,
-                                    rec_msg.data.mqtt_received.qos,
-                                    NULL);
+          ESP_LOGD(TAG, "Received MQTT message: %s", rec_msg.data.mqtt_received.topic);
+          // 只保存原始载荷，格式化推迟到显示时进行
+          lvgl_port_lock(0);
+          mqtt_display_add_raw(rec_msg.data.mqtt_received.topic,
+                               rec_msg.data.mqtt_received.payload,
+                               rec_msg.data.mqtt_received.payload_len,
+                               rec_msg.data.mqtt_received.qos,
+                               rec_msg.data.mqtt_received.retained,
+                               rec_msg.data.mqtt_received.rx_time_us);
+          lvgl_port_unlock();
+          bsp_lvgl_wake();  // LVGL任务空闲时可能在长时间睡眠，立即绘制新消息
           break;
         case LOGIC_MSG_MQTT_RESULT:  // MQTT操作结果消息
           if (rec_msg.data.mqtt_result.success) {
             ESP_LOGI(TAG, "MQTT operation succeeded");
           } else {
             ESP_LOGE(TAG, "MQTT operation failed: %s", rec_msg.data.mqtt_result.error_msg);
+            lvgl_port_lock(0);
             mqtt_display_add_system_msg(rec_msg.data.mqtt_result.error_msg, "ERROR");
+            lvgl_port_unlock();
           }
           break;
         case LOGIC_MSG_WIFI_STATUS:  // WiFi连接状态消息
@@ -132,27 +140,21 @@ void main_logic_task(void* pvParmeters) {
           
           // 连接到 MQTT 代理服务器
           ret = mqtt_tool_connect(&mqtt_tool);
+           lvgl_port_lock(0);
            if (ret != MQTT_TOOL_SUCCESS) {
                lv_label_set_text(ui_MqttState, "failed");
                ESP_LOGE(TAG, "Failed to connect to MQTT broker: %s", full_broker_uri);
               // mqtt_display_add_system_msg("Failed to connect to MQTT broker", "ERROR");
-               break;
            } else {
              // 连接成功
                lv_label_set_text(ui_MqttState, "Connected");
-               // Connect按钮变绿色并禁用
-               lv_obj_set_style_bg_color(ui_MqttConnect, lv_color_hex(0x4CAF50),
-                                         LV_PART_MAIN);
-               lv_obj_add_state(ui_MqttConnect, LV_STATE_DISABLED);
-                   
-               // Disconnect按钮变红并启用
-               lv_obj_set_style_bg_color(ui_MqttDisconnect, lv_color_hex(0xF44336),
-                                         LV_PART_MAIN);
-               lv_obj_clear_state(ui_MqttDisconnect, LV_STATE_DISABLED);
+               // Connect按钮变绿并禁用，Disconnect按钮变红并启用（连接界面未创建时在创建后应用）
+               ui_set_mqtt_connected(true);
 
                ESP_LOGI(TAG, "Connected to MQTT broker: %s", full_broker_uri);
                mqtt_display_add_system_msg("Connected to MQTT broker", "INFO");
            }
+           lvgl_port_unlock();
 
           break;
         case UI_MSG_MQTT_SUBSCRIBE:  // MQTT订阅请求
@@ -162,7 +164,9 @@ void main_logic_task(void* pvParmeters) {
               received_msg.data.subscribe_data.qos);
           // 处理订阅逻辑
           ESP_LOGI(TAG, "Subscribed to topic: %s", received_msg.data.subscribe_data.topic);
+          lvgl_port_lock(0);
           mqtt_display_add_system_msg("Subscribed to topic", "INFO");
+          lvgl_port_unlock();
           break;
 
         case UI_MSG_MQTT_PUBLISH:  // MQTT发布请求
@@ -173,7 +177,9 @@ void main_logic_task(void* pvParmeters) {
                 received_msg.data.publish_data.qos);
             ESP_LOGI(TAG, "Published message to topic: %s qos: %d", received_msg.data.publish_data.topic, received_msg.data.publish_data.qos);
             // 处理发布逻辑
+            lvgl_port_lock(0);
             mqtt_display_add_system_msg("Published message to topic", "INFO");
+            lvgl_port_unlock();
             break;
 
         case UI_MSG_WIFI_CONFIG:  // WiFi配置请求